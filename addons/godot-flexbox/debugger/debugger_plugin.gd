@@ -0,0 +1,52 @@
+# ############################################################################ #
+# Copyright 2016-2023 citizenl <hi@citizenl.me>
+# MIT License.
+# ############################################################################ #
+
+@tool
+extends EditorDebuggerPlugin
+
+# Rows kept per session, oldest passes are dropped first.
+const MAX_PASSES = 200
+
+var _trees = {}
+
+
+func _has_capture(prefix):
+	return prefix == "flexbox"
+
+
+func _capture(message, data, session_id):
+	if message != "flexbox:pass" or not _trees.has(session_id):
+		return false
+	# [root instance id, usec, nodes laid out, cache hits, measure callbacks]
+	var tree: Tree = _trees[session_id]
+	var root = tree.get_root()
+	if root.get_child_count() >= MAX_PASSES:
+		root.get_child(0).free()
+	var item = tree.create_item(root)
+	item.set_text(0, str(data[0]) if data[0] != 0 else "-")
+	for i in range(1, 5):
+		item.set_text(i, str(data[i]))
+	return true
+
+
+func _setup_session(session_id):
+	var tree = Tree.new()
+	tree.name = "Flexbox"
+	tree.columns = 5
+	tree.hide_root = true
+	tree.column_titles_visible = true
+	var titles = ["Root", "Usec", "Nodes", "Cache Hits", "Measures"]
+	for i in titles.size():
+		tree.set_column_title(i, titles[i])
+	tree.create_item()
+	_trees[session_id] = tree
+	var session = get_session(session_id)
+	session.started.connect(func(): _clear(tree))
+	session.add_session_tab(tree)
+
+
+func _clear(tree: Tree):
+	tree.clear()
+	tree.create_item()
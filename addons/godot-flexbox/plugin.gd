@@ -6,23 +6,27 @@
 @tool
 extends EditorPlugin
 
-const Icon = preload("icon.svg")
-const FlexContainer = preload("flex_container.gd")
 const InspectorPlugin = preload("inspector/inspector_plugin.gd")
+const DebuggerPlugin = preload("debugger/debugger_plugin.gd")
 var _inspector_plugin
+var _debugger_plugin
 
 
 func _enter_tree():
 	_get_theme()
 	_inspector_plugin = InspectorPlugin.new()
-	add_custom_type("FlexContainer", "Container", FlexContainer, Icon)
+	# FlexContainer is a native class of the GDExtension.
 	add_inspector_plugin(_inspector_plugin)
+	# Shows the "flexbox:pass" messages of FlexProfiler.
+	_debugger_plugin = DebuggerPlugin.new()
+	add_debugger_plugin(_debugger_plugin)
 
 
 func _exit_tree():
 	remove_inspector_plugin(_inspector_plugin)
-	remove_custom_type("FlexContainer")
 	_inspector_plugin = null
+	remove_debugger_plugin(_debugger_plugin)
+	_debugger_plugin = null
 
 
 
@@ -0,0 +1,395 @@
+// Headless layout benchmark for the Yoga core, built without godot-cpp:
+//   scons benchmark=yes target=release
+//   bin/yoga_bench [iterations] [scenario|all] [arena]
+#include "../src/yoga/Yoga.h"
+#include "../src/yoga/event/event.h"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+using namespace facebook::yoga;
+
+//====================================================
+// Allocation counting
+static std::atomic<uint64_t> g_allocations{0};
+
+void *operator new(std::size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = std::malloc(size == 0 ? 1 : size))
+    {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+void operator delete(void *p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+//====================================================
+// Cache statistics, gathered from LayoutPassEnd events
+struct PassStats
+{
+    uint64_t layouts = 0;
+    uint64_t measures = 0;
+    uint64_t cachedLayouts = 0;
+    uint64_t cachedMeasures = 0;
+    uint64_t measureCallbacks = 0;
+
+    double hitRate(void) const
+    {
+        const uint64_t cached = cachedLayouts + cachedMeasures;
+        const uint64_t total = cached + layouts + measures;
+        return total == 0 ? 0.0 : 100.0 * cached / total;
+    }
+};
+static PassStats g_stats;
+
+static void subscribeStats(void)
+{
+    Event::subscribe([](const YGNode &, Event::Type type, Event::Data data) {
+        if (type != Event::LayoutPassEnd)
+        {
+            return;
+        }
+        const LayoutData *layoutData = data.get<Event::LayoutPassEnd>().layoutData;
+        g_stats.layouts += layoutData->layouts;
+        g_stats.measures += layoutData->measures;
+        g_stats.cachedLayouts += layoutData->cachedLayouts;
+        g_stats.cachedMeasures += layoutData->cachedMeasures;
+        g_stats.measureCallbacks += layoutData->measureCallbacks;
+    });
+}
+
+//====================================================
+// Text-like measure func: the context holds a glyph count, lines wrap at the
+// available width.
+static YGSize measureText(YGNodeRef node, float width, YGMeasureMode widthMode, float height, YGMeasureMode heightMode)
+{
+    const float glyphs = static_cast<float>(reinterpret_cast<intptr_t>(YGNodeGetContext(node)));
+    const float glyphWidth = 7.0f;
+    const float lineHeight = 16.0f;
+    const float natural = glyphs * glyphWidth;
+
+    float w = natural;
+    if (widthMode == YGMeasureModeExactly || (widthMode == YGMeasureModeAtMost && natural > width))
+    {
+        w = width;
+    }
+    const float lines = w > 0.0f ? std::ceil(natural / w) : glyphs;
+    float h = lines * lineHeight;
+    if (heightMode == YGMeasureModeExactly || (heightMode == YGMeasureModeAtMost && h > height))
+    {
+        h = height;
+    }
+    return {w, h};
+}
+
+static YGNodeRef newTextNode(YGConfigRef config, int glyphs)
+{
+    YGNodeRef node = YGNodeNewWithConfig(config);
+    YGNodeSetContext(node, reinterpret_cast<void *>(static_cast<intptr_t>(glyphs)));
+    YGNodeSetMeasureFunc(node, measureText);
+    return node;
+}
+
+//====================================================
+// Scenarios. Each returns the root and the leaf that is poked for the
+// incremental measurement.
+struct Tree
+{
+    YGNodeRef root;
+    YGNodeRef leaf;
+};
+
+static Tree buildDeepColumn(YGConfigRef config)
+{
+    YGNodeRef root = YGNodeNewWithConfig(config);
+    YGNodeStyleSetFlexDirection(root, YGFlexDirectionColumn);
+    YGNodeStyleSetWidth(root, 800);
+
+    YGNodeRef parent = root;
+    YGNodeRef leaf = nullptr;
+    for (int depth = 0; depth < 100; depth++)
+    {
+        leaf = YGNodeNewWithConfig(config);
+        YGNodeStyleSetHeight(leaf, 10);
+        YGNodeStyleSetMargin(leaf, YGEdgeBottom, 2);
+        YGNodeInsertChild(parent, leaf, 0);
+
+        YGNodeRef next = YGNodeNewWithConfig(config);
+        YGNodeStyleSetFlexDirection(next, YGFlexDirectionColumn);
+        YGNodeStyleSetPadding(next, YGEdgeAll, 1);
+        YGNodeInsertChild(parent, next, 1);
+        parent = next;
+    }
+    return {root, leaf};
+}
+
+static Tree buildWrapGrid(YGConfigRef config)
+{
+    YGNodeRef root = YGNodeNewWithConfig(config);
+    YGNodeStyleSetFlexDirection(root, YGFlexDirectionRow);
+    YGNodeStyleSetFlexWrap(root, YGWrapWrap);
+    YGNodeStyleSetAlignContent(root, YGAlignFlexStart);
+    YGNodeStyleSetWidth(root, 1000);
+    YGNodeStyleSetGap(root, YGGutterAll, 4);
+
+    YGNodeRef leaf = nullptr;
+    for (int i = 0; i < 2000; i++)
+    {
+        leaf = YGNodeNewWithConfig(config);
+        YGNodeStyleSetWidth(leaf, 40 + (i % 7) * 3);
+        YGNodeStyleSetHeight(leaf, 30);
+        YGNodeStyleSetFlexGrow(leaf, (i % 3) == 0 ? 1 : 0);
+        YGNodeInsertChild(root, leaf, i);
+    }
+    return {root, leaf};
+}
+
+static Tree buildNestedRowsMeasured(YGConfigRef config)
+{
+    YGNodeRef root = YGNodeNewWithConfig(config);
+    YGNodeStyleSetFlexDirection(root, YGFlexDirectionColumn);
+    YGNodeStyleSetWidth(root, 1000);
+
+    YGNodeRef leaf = nullptr;
+    for (int r = 0; r < 40; r++)
+    {
+        YGNodeRef row = YGNodeNewWithConfig(config);
+        YGNodeStyleSetFlexDirection(row, YGFlexDirectionRow);
+        YGNodeStyleSetAlignItems(row, YGAlignCenter);
+        YGNodeStyleSetPadding(row, YGEdgeHorizontal, 8);
+        YGNodeInsertChild(root, row, r);
+        for (int c = 0; c < 6; c++)
+        {
+            YGNodeRef cell = YGNodeNewWithConfig(config);
+            YGNodeStyleSetFlexDirection(cell, YGFlexDirectionRow);
+            YGNodeStyleSetFlexShrink(cell, 1);
+            YGNodeStyleSetFlexGrow(cell, c == 0 ? 1 : 0);
+            YGNodeInsertChild(row, cell, c);
+
+            leaf = newTextNode(config, 5 + (r * 7 + c * 13) % 40);
+            YGNodeStyleSetFlexShrink(leaf, 1);
+            YGNodeInsertChild(cell, leaf, 0);
+        }
+    }
+    return {root, leaf};
+}
+
+static Tree buildAbsoluteOverlays(YGConfigRef config)
+{
+    YGNodeRef root = YGNodeNewWithConfig(config);
+    YGNodeStyleSetFlexDirection(root, YGFlexDirectionRow);
+    YGNodeStyleSetFlexWrap(root, YGWrapWrap);
+    YGNodeStyleSetWidth(root, 1280);
+    YGNodeStyleSetHeight(root, 720);
+
+    YGNodeRef leaf = nullptr;
+    for (int p = 0; p < 60; p++)
+    {
+        YGNodeRef panel = YGNodeNewWithConfig(config);
+        YGNodeStyleSetWidthPercent(panel, 10);
+        YGNodeStyleSetHeight(panel, 100);
+        YGNodeInsertChild(root, panel, p);
+        for (int o = 0; o < 10; o++)
+        {
+            leaf = YGNodeNewWithConfig(config);
+            YGNodeStyleSetPositionType(leaf, YGPositionTypeAbsolute);
+            if (o % 2 == 0)
+            {
+                YGNodeStyleSetPosition(leaf, YGEdgeLeft, o * 2);
+                YGNodeStyleSetPosition(leaf, YGEdgeTop, o * 3);
+                YGNodeStyleSetWidth(leaf, 20);
+                YGNodeStyleSetHeight(leaf, 20);
+            }
+            else
+            {
+                YGNodeStyleSetPositionPercent(leaf, YGEdgeRight, 5);
+                YGNodeStyleSetPositionPercent(leaf, YGEdgeBottom, 5);
+                YGNodeStyleSetWidthPercent(leaf, 50);
+                YGNodeStyleSetHeightPercent(leaf, 25);
+            }
+            YGNodeInsertChild(panel, leaf, o);
+        }
+    }
+    return {root, leaf};
+}
+
+static void addPercentLevel(YGConfigRef config, YGNodeRef parent, int depth, YGNodeRef &leaf)
+{
+    for (int i = 0; i < 4; i++)
+    {
+        YGNodeRef node = YGNodeNewWithConfig(config);
+        YGNodeStyleSetFlexDirection(node, (depth % 2) == 0 ? YGFlexDirectionRow : YGFlexDirectionColumn);
+        YGNodeStyleSetWidthPercent(node, 25);
+        YGNodeStyleSetHeightPercent(node, 90);
+        YGNodeStyleSetPaddingPercent(node, YGEdgeAll, 1);
+        YGNodeStyleSetMarginPercent(node, YGEdgeLeft, 0.5f);
+        YGNodeStyleSetMinWidthPercent(node, 5);
+        YGNodeInsertChild(parent, node, i);
+        if (depth > 0)
+        {
+            addPercentLevel(config, node, depth - 1, leaf);
+        }
+        else
+        {
+            leaf = node;
+        }
+    }
+}
+
+static Tree buildPercentageHeavy(YGConfigRef config)
+{
+    YGNodeRef root = YGNodeNewWithConfig(config);
+    YGNodeStyleSetFlexDirection(root, YGFlexDirectionRow);
+    YGNodeStyleSetWidth(root, 1920);
+    YGNodeStyleSetHeight(root, 1080);
+
+    YGNodeRef leaf = nullptr;
+    addPercentLevel(config, root, 4, leaf);
+    return {root, leaf};
+}
+
+struct Scenario
+{
+    const char *name;
+    Tree (*build)(YGConfigRef config);
+};
+
+static const Scenario kScenarios[] = {
+    {"deep_column", buildDeepColumn},
+    {"wrap_grid", buildWrapGrid},
+    {"nested_rows_measure", buildNestedRowsMeasured},
+    {"absolute_overlays", buildAbsoluteOverlays},
+    {"percentage_heavy", buildPercentageHeavy},
+};
+
+//====================================================
+static uint32_t countNodes(YGNodeRef node)
+{
+    uint32_t count = 1;
+    const uint32_t childCount = YGNodeGetChildCount(node);
+    for (uint32_t i = 0; i < childCount; i++)
+    {
+        count += countNodes(YGNodeGetChild(node, i));
+    }
+    return count;
+}
+
+struct Sample
+{
+    double nsPerNode = 0;
+    double allocsPerPass = 0;
+    double measuresPerPass = 0;
+    PassStats stats;
+};
+
+template <typename Poke>
+static Sample measurePasses(YGNodeRef root, uint32_t nodes, int iterations, Poke poke)
+{
+    g_stats = PassStats();
+    const uint64_t allocsBefore = g_allocations.load();
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+    {
+        poke(i);
+        YGNodeCalculateLayout(root, YGUndefined, YGUndefined, YGDirectionLTR);
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    Sample sample;
+    const double ns = std::chrono::duration<double, std::nano>(end - start).count();
+    sample.nsPerNode = ns / (static_cast<double>(iterations) * nodes);
+    sample.allocsPerPass = static_cast<double>(g_allocations.load() - allocsBefore) / iterations;
+    sample.measuresPerPass = static_cast<double>(g_stats.measureCallbacks) / iterations;
+    sample.stats = g_stats;
+    return sample;
+}
+
+static void printSample(const char *scenario, const char *pass, uint32_t nodes, const Sample &sample)
+{
+    printf("%-22s %-8s %7u %10.1f %10.1f %8.1f%% %10.1f\n",
+        scenario, pass, nodes, sample.nsPerNode, sample.allocsPerPass,
+        sample.stats.hitRate(), sample.measuresPerPass);
+}
+
+static void runScenario(const Scenario &scenario, int iterations, bool useArena)
+{
+    YGConfigRef config = YGConfigNew();
+    YGNodeArenaRef arena = useArena ? YGNodeArenaNew() : nullptr;
+    YGConfigSetNodeArena(config, arena);
+    const Tree tree = scenario.build(config);
+    const uint32_t nodes = countNodes(tree.root);
+    const float rootWidth = YGNodeStyleGetWidth(tree.root).value;
+
+    // cold: first pass over the freshly built tree
+    {
+        Sample cold = measurePasses(tree.root, nodes, 1, [](int) {});
+        printSample(scenario.name, "cold", nodes, cold);
+    }
+    // resize: the root width changes every pass, the whole tree is relaid out
+    {
+        Sample resize = measurePasses(tree.root, nodes, iterations, [&](int i) {
+            YGNodeStyleSetWidth(tree.root, rootWidth + (i % 2));
+        });
+        printSample(scenario.name, "resize", nodes, resize);
+    }
+    // leaf: a single leaf changes, everything else should come from the cache
+    {
+        const YGValue leafMargin = YGNodeStyleGetMargin(tree.leaf, YGEdgeTop);
+        const float base = YGFloatIsUndefined(leafMargin.value) ? 0.0f : leafMargin.value;
+        Sample leaf = measurePasses(tree.root, nodes, iterations, [&](int i) {
+            YGNodeStyleSetMargin(tree.leaf, YGEdgeTop, base + (i % 2));
+        });
+        printSample(scenario.name, "leaf", nodes, leaf);
+    }
+    // clean: nothing changed, the pass should be close to free
+    {
+        Sample clean = measurePasses(tree.root, nodes, iterations, [](int) {});
+        printSample(scenario.name, "clean", nodes, clean);
+    }
+
+    YGNodeFreeRecursive(tree.root);
+    if (arena != nullptr)
+    {
+        YGNodeArenaFree(arena);
+    }
+    YGConfigFree(config);
+}
+
+int main(int argc, char **argv)
+{
+    const int iterations = argc > 1 ? std::atoi(argv[1]) : 200;
+    const char *filter = argc > 2 && std::strcmp(argv[2], "all") != 0 ? argv[2] : nullptr;
+    const bool useArena = argc > 3 && std::strcmp(argv[3], "arena") == 0;
+    if (iterations <= 0)
+    {
+        fprintf(stderr, "usage: %s [iterations] [scenario|all] [arena]\n", argv[0]);
+        return 1;
+    }
+
+    subscribeStats();
+    printf("%-22s %-8s %7s %10s %10s %9s %10s\n",
+        "scenario", "pass", "nodes", "ns/node", "allocs", "cache", "measures");
+    for (const Scenario &scenario : kScenarios)
+    {
+        if (filter == nullptr || std::strcmp(filter, scenario.name) == 0)
+        {
+            runScenario(scenario, iterations, useArena);
+        }
+    }
+    Event::reset();
+    return 0;
+}
@@ -22,6 +22,144 @@ func _ready():
 	var e = Time.get_ticks_usec()
 	print("layout time>",e-calc)
 	print("total  time>",e-s, " avg:", (e-s) / TOTAL_COUNT)
+	test_tree_round_trip()
+	test_apply_style_packed()
+	test_build_tree()
+	test_set_children()
+
+
+func test_tree_round_trip():
+	var root = Flexbox.new()
+	root.apply_style({flex_direction = 2, width = 300, padding = 5}) # row
+	var childs = []
+	for i in range(3):
+		var child = Flexbox.new()
+		child.apply_style({width = "25%", height = 40 + i, margin = [1, 2, 3, 4]})
+		childs.append(child)
+		root.insert_child(child, i)
+	root.calculate_layout(NAN, NAN, 1)
+
+	var blob = root.serialize_tree(true)
+	var copy = Flexbox.new()
+	copy.deserialize_tree(blob)
+	assert(copy.serialize_tree(true) == blob)
+	assert(copy.get_child_count() == 3)
+	for i in range(3):
+		assert(copy.get_child(i).get_computed_layout() == childs[i].get_computed_layout())
+	copy.calculate_layout(NAN, NAN, 1)
+	assert(copy.serialize_tree(true) == blob)
+
+	# A deserialized child moved to another parent outlives its old one.
+	var moved = copy.get_child(1)
+	copy.remove_child(moved)
+	var other = Flexbox.new()
+	other.insert_child(moved, 0)
+	copy = null
+	assert(other.get_child_count() == 1)
+	assert(other.get_child(0) == moved)
+
+	# Rejected blobs leave the target untouched.
+	var target = Flexbox.new()
+	target.apply_style({width = 10})
+	var before = target.serialize_tree(false)
+	var bad_magic = blob.duplicate()
+	bad_magic[0] = 0
+	target.deserialize_tree(bad_magic)
+	assert(target.serialize_tree(false) == before)
+	target.deserialize_tree(blob.slice(0, blob.size() - 1))
+	assert(target.serialize_tree(false) == before)
+	target.set_measure_func(Callable(self, "measure"))
+	target.deserialize_tree(blob)
+	assert(target.get_child_count() == 0)
+	assert(target.serialize_tree(false) == before)
+	print("tree round trip ok")
+
+
+func style_record(property, edge, unit, value):
+	var record = PackedByteArray()
+	record.resize(Flexbox.STYLE_RECORD_SIZE)
+	record.encode_u8(0, property)
+	record.encode_u8(1, edge)
+	record.encode_u8(2, unit)
+	record.encode_float(4, value)
+	return record
+
+
+func test_apply_style_packed():
+	var node = Flexbox.new()
+	var before = node.get_style_fixed_packed()
+	# Rejected records leave the style untouched.
+	node.apply_style_packed(style_record(Flexbox.STYLE_MARGIN, 9, 1, 5)) # edge past all
+	node.apply_style_packed(style_record(Flexbox.STYLE_GAP, 3, 1, 5)) # gutter past all
+	node.apply_style_packed(style_record(Flexbox.STYLE_FLEX_DIRECTION, 0, 0, 4)) # no 5th direction
+	node.apply_style_packed(style_record(Flexbox.STYLE_FLEX_DIRECTION, 0, 0, -1))
+	node.apply_style_packed(style_record(Flexbox.STYLE_PROPERTY_MAX, 0, 1, 5))
+	node.apply_style_packed(style_record(Flexbox.STYLE_WIDTH, 0, 4, 5)) # unit past auto
+	node.apply_style_packed(style_record(Flexbox.STYLE_WIDTH, 0, 1, 5).slice(0, 7))
+	assert(node.get_style_fixed_packed() == before)
+
+	var style = style_record(Flexbox.STYLE_WIDTH, 0, 1, 120)
+	style.append_array(style_record(Flexbox.STYLE_GAP, 2, 1, 4))
+	node.apply_style_packed(style)
+	assert(node.get_style_fixed_packed() != before)
+	node.calculate_layout(NAN, NAN, 1)
+	assert(node.get_computed_width() == 120)
+	print("apply style packed ok")
+
+
+func test_build_tree():
+	var tree = FlexTree.new()
+	var styles = style_record(Flexbox.STYLE_WIDTH, 0, 1, 100)
+	styles.append_array(style_record(Flexbox.STYLE_WIDTH, 0, 1, 20))
+	var parents = PackedInt32Array([-1, 0, 0])
+	var ranges = PackedInt32Array([0, 1, 1, 1, 1, 1])
+	# Rejected input creates no nodes.
+	assert(tree.build_tree(parents, styles.slice(0, 12), ranges).is_empty())
+	assert(tree.build_tree(parents, styles, PackedInt32Array([0, 1])).is_empty())
+	assert(tree.build_tree(PackedInt32Array([-1, 1, 0]), styles, ranges).is_empty())
+	assert(tree.build_tree(PackedInt32Array([-2, 0, 0]), styles, ranges).is_empty())
+	assert(tree.build_tree(parents, styles, PackedInt32Array([0, 1, 1, 2, 1, 1])).is_empty())
+	assert(tree.build_tree(parents, styles, PackedInt32Array([0, 1, -1, 1, 1, 1])).is_empty())
+	assert(tree.get_node_count() == 0)
+
+	var nodes = tree.build_tree(parents, styles, ranges)
+	assert(nodes.size() == 3)
+	assert(tree.get_child_count(nodes[0]) == 2)
+	assert(tree.get_parent(nodes[2]) == nodes[0])
+	tree.calculate_layout(nodes[0], NAN, NAN, 1)
+	assert(tree.get_layout(nodes[0]).size.x == 100)
+	assert(tree.get_layout(nodes[1]).size.x == 20)
+	print("build tree ok")
+
+
+func test_set_children():
+	var parent = Flexbox.new()
+	var child = Flexbox.new()
+	var grandchild = Flexbox.new()
+	parent.set_children([child])
+	child.set_children([grandchild])
+	# Rejected lists leave the children as they were.
+	parent.set_children([parent])
+	grandchild.set_children([parent])
+	assert(grandchild.get_child_count() == 0)
+	var other = Flexbox.new()
+	parent.set_children([child, other, other])
+	assert(parent.get_child_count() == 1)
+	parent.set_children([grandchild])
+	assert(parent.get_child(0) == child)
+	parent.set_children([child, 1])
+	assert(parent.get_child_count() == 1)
+	var measured = Flexbox.new()
+	measured.set_measure_func(Callable(self, "measure"))
+	measured.set_children([other])
+	assert(measured.get_child_count() == 0)
+
+	# Children already in place may be reordered.
+	parent.set_children([other, child])
+	assert(parent.get_child_count() == 2)
+	assert(parent.get_child(0) == other)
+	assert(parent.get_child(1) == child)
+	print("set children ok")
 
 
 func measure(width, widthMode,height, heightMode):
@@ -0,0 +1,339 @@
+#include "flex_container.h"
+
+#include <godot_cpp/core/class_db.hpp>
+
+using namespace godot;
+FlexContainer::FlexContainer()
+{
+    m_root.instantiate();
+    m_root->set_flex_direction(YGFlexDirectionRow);
+    m_root->set_flex_wrap(YGWrapNoWrap);
+    m_root->set_justify_content(YGJustifyFlexStart);
+    m_root->set_align_items(YGAlignFlexStart);
+    m_root->set_align_content(YGAlignAuto);
+}
+FlexContainer::~FlexContainer()
+{
+    // Scripts may still hold the root through get_root(), detach our children.
+    YGNodeRemoveAllChildren(m_root->m_node);
+    m_flexCache.clear();
+}
+
+//====================================================
+void FlexContainer::set_flex_direction(int flexDirection)
+{
+    m_root->set_flex_direction(flexDirection);
+    queue_sort();
+}
+int FlexContainer::get_flex_direction(void) const
+{
+    return m_root->get_flex_direction();
+}
+
+void FlexContainer::set_flex_wrap(int flexWrap)
+{
+    m_root->set_flex_wrap(flexWrap);
+    queue_sort();
+}
+int FlexContainer::get_flex_wrap(void) const
+{
+    return m_root->get_flex_wrap();
+}
+
+void FlexContainer::set_justify_content(int justifyContent)
+{
+    m_root->set_justify_content(justifyContent);
+    queue_sort();
+}
+int FlexContainer::get_justify_content(void) const
+{
+    return m_root->get_justify_content();
+}
+
+void FlexContainer::set_align_items(int alignItems)
+{
+    m_root->set_align_items(alignItems);
+    queue_sort();
+}
+int FlexContainer::get_align_items(void) const
+{
+    return m_root->get_align_items();
+}
+
+void FlexContainer::set_align_content(int alignContent)
+{
+    m_root->set_align_content(alignContent);
+    queue_sort();
+}
+int FlexContainer::get_align_content(void) const
+{
+    return m_root->get_align_content();
+}
+
+void FlexContainer::set_debug_draw(bool debugDraw)
+{
+    m_debugDraw = debugDraw;
+    queue_sort();
+}
+bool FlexContainer::get_debug_draw(void) const
+{
+    return m_debugDraw;
+}
+
+void FlexContainer::set_layout_cache(const Ref<FlexLayoutCache> &layoutCache)
+{
+    m_layoutCache = layoutCache;
+}
+Ref<FlexLayoutCache> FlexContainer::get_layout_cache(void) const
+{
+    return m_layoutCache;
+}
+//
+
+void FlexContainer::update_layout(void)
+{
+    queue_sort();
+}
+
+Ref<Flexbox> FlexContainer::get_root(void) const
+{
+    return m_root;
+}
+
+Ref<Flexbox> FlexContainer::get_child_flexbox(Control *child) const
+{
+    if (child == nullptr)
+    {
+        return Ref<Flexbox>();
+    }
+    auto it = m_flexCache.find(child->get_instance_id());
+    if (it == m_flexCache.end())
+    {
+        return Ref<Flexbox>();
+    }
+    return it->second.flexbox;
+}
+
+//====================================================
+void FlexContainer::_notification(int p_what)
+{
+    switch (p_what)
+    {
+    case NOTIFICATION_SORT_CHILDREN:
+        _resort();
+        break;
+    case NOTIFICATION_TRANSLATION_CHANGED:
+    case NOTIFICATION_LAYOUT_DIRECTION_CHANGED:
+        queue_sort();
+        break;
+    case NOTIFICATION_DRAW:
+        for (const DebugRect &r : m_drawRects)
+        {
+            draw_rect(r.rect, r.color, false, 2);
+        }
+        break;
+    }
+}
+
+FlexContainer::ChildEntry &FlexContainer::_get_or_create_entry(Control *child)
+{
+    ChildEntry &entry = m_flexCache[child->get_instance_id()];
+    if (entry.flexbox.is_null())
+    {
+        entry.flexbox.instantiate();
+    }
+    entry.control = child;
+    return entry;
+}
+
+// Back to the default style, without leaving the tree.
+static void resetStyle(YGNodeRef node)
+{
+    const YGNodeRef defaults = YGNodeNewWithConfig(YGNodeGetConfig(node));
+    YGNodeCopyStyle(node, defaults);
+    YGNodeFree(defaults);
+}
+
+void FlexContainer::_sync_child_style(ChildEntry &entry)
+{
+    Control *c = entry.control;
+    Flexbox *flexbox = entry.flexbox.ptr();
+
+    // Metas may be edited in place, a copy is kept to compare against.
+    const Variant flexMetas = c->get_meta("_flex_metas", -1);
+    const bool hasMetas = flexMetas.get_type() == Variant::DICTIONARY;
+    const Dictionary metas = hasMetas ? static_cast<Dictionary>(flexMetas) : Dictionary();
+    const bool metasChanged = hasMetas != entry.hasMetas || metas != entry.metas;
+    if (metasChanged && entry.hasMetas)
+    {
+        // Values of removed keys must not stay behind.
+        resetStyle(flexbox->m_node);
+        entry.minSize = Vector2(-1, -1);
+    }
+
+    const Vector2 size = c->get_custom_minimum_size();
+    if (size != entry.minSize)
+    {
+        flexbox->set_min_width(size.x);
+        flexbox->set_min_height(size.y);
+        entry.minSize = size;
+    }
+
+    if (metasChanged)
+    {
+        if (hasMetas)
+        {
+            flexbox->apply_style(metas);
+        }
+        entry.hasMetas = hasMetas;
+        entry.metas = metas.duplicate(true);
+    }
+}
+
+void FlexContainer::_resort(void)
+{
+    m_drawRects.clear();
+    m_childNodes.clear();
+    m_sortedEntries.clear();
+
+    // Unchanged values are skipped here so unrelated sorts never dirty the tree.
+    const Size2 rootSize = get_size();
+    if (rootSize != m_lastSize)
+    {
+        m_root->set_width(rootSize.x);
+        m_root->set_height(rootSize.y);
+        m_lastSize = rootSize;
+    }
+    if (m_debugDraw)
+    {
+        m_drawRects.push_back({Rect2(Vector2(), rootSize), Color(0, 0.8, 0.5, 1)});
+    }
+    //
+    const int childCount = get_child_count();
+    for (int i = 0; i < childCount; i++)
+    {
+        Control *c = Object::cast_to<Control>(get_child(i));
+        if (c == nullptr || c->is_set_as_top_level() || !c->is_visible_in_tree())
+        {
+            continue;
+        }
+        c->set_meta("_flex_child", 1);
+
+        ChildEntry &entry = _get_or_create_entry(c);
+        _sync_child_style(entry);
+        m_childNodes.push_back(entry.flexbox->m_node);
+        m_sortedEntries.push_back(&entry);
+    }
+
+    // Only touch the Yoga hierarchy when the visible children actually changed.
+    const YGNodeRef rootNode = m_root->m_node;
+    bool childrenChanged = YGNodeGetChildCount(rootNode) != m_childNodes.size();
+    for (uint32_t i = 0; !childrenChanged && i < m_childNodes.size(); i++)
+    {
+        childrenChanged = YGNodeGetChild(rootNode, i) != m_childNodes[i];
+    }
+    if (childrenChanged)
+    {
+        YGNodeSetChildren(rootNode, m_childNodes);
+    }
+
+    // Drop cached nodes of children that left the container.
+    if (m_flexCache.size() > m_sortedEntries.size())
+    {
+        for (auto it = m_flexCache.begin(); it != m_flexCache.end();)
+        {
+            Control *c = Object::cast_to<Control>(ObjectDB::get_instance(it->first));
+            if (c == nullptr || c->get_parent() != this)
+            {
+                const YGNodeRef node = it->second.flexbox->m_node;
+                YGNodeRef owner = YGNodeGetOwner(node);
+                if (owner != nullptr)
+                {
+                    YGNodeRemoveChild(owner, node);
+                }
+                it = m_flexCache.erase(it);
+            }
+            else
+            {
+                if (YGNodeGetOwner(it->second.flexbox->m_node) == nullptr)
+                {
+                    // Hidden children are re-fitted when they come back.
+                    it->second.fitted = false;
+                }
+                ++it;
+            }
+        }
+    }
+    //
+    const YGDirection direction = is_layout_rtl() ? YGDirectionRTL : YGDirectionLTR;
+    if (YGNodeNeedsLayout(rootNode) || direction != m_lastDirection)
+    {
+        if (m_layoutCache.is_valid())
+        {
+            m_layoutCache->calculate_layout(m_root.ptr(), YGUndefined, YGUndefined, direction);
+        }
+        else
+        {
+            m_root->calculate_layout(YGUndefined, YGUndefined, direction);
+        }
+        m_lastDirection = direction;
+    }
+    //
+    for (ChildEntry *entry : m_sortedEntries)
+    {
+        const YGNodeRef node = entry->flexbox->m_node;
+        if (YGNodeGetHasNewLayout(node))
+        {
+            entry->rect = Rect2(
+                YGNodeLayoutGetLeft(node),
+                YGNodeLayoutGetTop(node),
+                YGNodeLayoutGetWidth(node),
+                YGNodeLayoutGetHeight(node));
+            YGNodeSetHasNewLayout(node, false);
+            entry->fitted = false;
+        }
+        if (m_debugDraw)
+        {
+            m_drawRects.push_back({entry->rect, Color(1, 0, 0, 0.8)});
+        }
+        // A child moved or resized from outside is still snapped back.
+        if (!entry->fitted || entry->control->get_rect() != entry->rect)
+        {
+            fit_child_in_rect(entry->control, entry->rect);
+            entry->fitted = true;
+        }
+    }
+    queue_redraw();
+}
+
+void FlexContainer::_bind_methods()
+{
+    ClassDB::bind_method(D_METHOD("set_flex_direction"), &FlexContainer::set_flex_direction);
+    ClassDB::bind_method(D_METHOD("get_flex_direction"), &FlexContainer::get_flex_direction);
+    ClassDB::bind_method(D_METHOD("set_flex_wrap"), &FlexContainer::set_flex_wrap);
+    ClassDB::bind_method(D_METHOD("get_flex_wrap"), &FlexContainer::get_flex_wrap);
+    ClassDB::bind_method(D_METHOD("set_justify_content"), &FlexContainer::set_justify_content);
+    ClassDB::bind_method(D_METHOD("get_justify_content"), &FlexContainer::get_justify_content);
+    ClassDB::bind_method(D_METHOD("set_align_items"), &FlexContainer::set_align_items);
+    ClassDB::bind_method(D_METHOD("get_align_items"), &FlexContainer::get_align_items);
+    ClassDB::bind_method(D_METHOD("set_align_content"), &FlexContainer::set_align_content);
+    ClassDB::bind_method(D_METHOD("get_align_content"), &FlexContainer::get_align_content);
+    ClassDB::bind_method(D_METHOD("set_debug_draw"), &FlexContainer::set_debug_draw);
+    ClassDB::bind_method(D_METHOD("get_debug_draw"), &FlexContainer::get_debug_draw);
+    ClassDB::bind_method(D_METHOD("set_layout_cache"), &FlexContainer::set_layout_cache);
+    ClassDB::bind_method(D_METHOD("get_layout_cache"), &FlexContainer::get_layout_cache);
+
+    ClassDB::bind_method(D_METHOD("update_layout"), &FlexContainer::update_layout);
+    ClassDB::bind_method(D_METHOD("get_root"), &FlexContainer::get_root);
+    ClassDB::bind_method(D_METHOD("get_child_flexbox"), &FlexContainer::get_child_flexbox);
+
+    // Property names match the former script version so saved scenes keep
+    // their values.
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "debug_draw"), "set_debug_draw", "get_debug_draw");
+    ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "layout_cache", PROPERTY_HINT_RESOURCE_TYPE, "FlexLayoutCache"), "set_layout_cache", "get_layout_cache");
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "flex/flex_direction", PROPERTY_HINT_ENUM, "Column,ColumnReverse,Row,RowReverse"), "set_flex_direction", "get_flex_direction");
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "flex/flex_wrap", PROPERTY_HINT_ENUM, "NoWrap,Wrap,WrapReverse"), "set_flex_wrap", "get_flex_wrap");
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "alignment/justify_content", PROPERTY_HINT_ENUM, "FlexStart,Center,FlexEnd,SpaceBetween,SpaceAround,SpaceEvenly"), "set_justify_content", "get_justify_content");
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "alignment/align_items", PROPERTY_HINT_ENUM, "Auto,FlexStart,Center,FlexEnd,Stretch,Baseline,SpaceBetween,SpaceAround"), "set_align_items", "get_align_items");
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "alignment/align_content", PROPERTY_HINT_ENUM, "Auto,FlexStart,Center,FlexEnd,Stretch,Baseline,SpaceBetween,SpaceAround"), "set_align_content", "get_align_content");
+}
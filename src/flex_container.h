@@ -0,0 +1,87 @@
+#ifndef FLEX_CONTAINER_CLASS_H
+#define FLEX_CONTAINER_CLASS_H
+
+#include <godot_cpp/classes/container.hpp>
+#include <godot_cpp/classes/control.hpp>
+#include <godot_cpp/variant/dictionary.hpp>
+#include <godot_cpp/variant/rect2.hpp>
+
+#include <unordered_map>
+#include <vector>
+#include "flexbox.h"
+#include "flex_layout_cache.h"
+
+using namespace godot;
+
+// Container laying out its Control children with a Flexbox per child.
+// Owns the Yoga tree of its children and does the whole sort in C++.
+class FlexContainer : public Container
+{
+    GDCLASS(FlexContainer, Container);
+
+protected:
+    static void _bind_methods();
+    void _notification(int p_what);
+
+public:
+    FlexContainer();
+    ~FlexContainer();
+
+public: // Container properties
+    void set_flex_direction(int flexDirection);
+    int get_flex_direction(void) const;
+    void set_flex_wrap(int flexWrap);
+    int get_flex_wrap(void) const;
+    void set_justify_content(int justifyContent);
+    int get_justify_content(void) const;
+    void set_align_items(int alignItems);
+    int get_align_items(void) const;
+    void set_align_content(int alignContent);
+    int get_align_content(void) const;
+
+    void set_debug_draw(bool debugDraw);
+    bool get_debug_draw(void) const;
+    // Consulted before every layout, a hit skips Yoga altogether.
+    void set_layout_cache(const Ref<FlexLayoutCache> &layoutCache);
+    Ref<FlexLayoutCache> get_layout_cache(void) const;
+
+public:
+    void update_layout(void);
+    Ref<Flexbox> get_root(void) const;
+    Ref<Flexbox> get_child_flexbox(Control *child) const;
+
+private:
+    struct DebugRect
+    {
+        Rect2 rect;
+        Color color;
+    };
+
+    // What was last pushed into / read out of a child's Yoga node.
+    struct ChildEntry
+    {
+        Ref<Flexbox> flexbox;
+        Control *control = nullptr;
+        Vector2 minSize = Vector2(-1, -1);
+        Dictionary metas;
+        bool hasMetas = false;
+        bool fitted = false;
+        Rect2 rect;
+    };
+
+    void _resort(void);
+    ChildEntry &_get_or_create_entry(Control *child);
+    void _sync_child_style(ChildEntry &entry);
+
+    Ref<Flexbox> m_root;
+    Ref<FlexLayoutCache> m_layoutCache;
+    std::unordered_map<uint64_t, ChildEntry> m_flexCache;
+    std::vector<ChildEntry *> m_sortedEntries;
+    std::vector<YGNodeRef> m_childNodes;
+    std::vector<DebugRect> m_drawRects;
+    Size2 m_lastSize = Size2(-1, -1);
+    YGDirection m_lastDirection = YGDirectionInherit;
+    bool m_debugDraw = false;
+};
+
+#endif
@@ -0,0 +1,104 @@
+#include "flex_dirtied_queue.h"
+
+#include <godot_cpp/classes/engine.hpp>
+#include <godot_cpp/core/class_db.hpp>
+
+#include "flexbox.h"
+
+using namespace godot;
+
+FlexDirtiedQueue *FlexDirtiedQueue::singleton = nullptr;
+
+void FlexDirtiedQueue::initialize(void)
+{
+    singleton = memnew(FlexDirtiedQueue);
+    Engine::get_singleton()->register_singleton("FlexDirtiedQueue", singleton);
+}
+
+void FlexDirtiedQueue::uninitialize(void)
+{
+    if (singleton == nullptr)
+    {
+        return;
+    }
+    Engine::get_singleton()->unregister_singleton("FlexDirtiedQueue");
+    memdelete(singleton);
+    singleton = nullptr;
+}
+
+FlexDirtiedQueue *FlexDirtiedQueue::get_singleton(void)
+{
+    return singleton;
+}
+
+void FlexDirtiedQueue::push(Flexbox *node)
+{
+    if (node->m_dirtiedPending)
+    {
+        return;
+    }
+    node->m_dirtiedPending = true;
+    m_pending.push_back(node->get_instance_id());
+    if (!m_flushScheduled)
+    {
+        m_flushScheduled = true;
+        call_deferred("flush");
+    }
+}
+
+void FlexDirtiedQueue::set_callback(const Callable &callback)
+{
+    m_callback = callback;
+}
+
+Callable FlexDirtiedQueue::get_callback(void) const
+{
+    return m_callback;
+}
+
+void FlexDirtiedQueue::flush(void)
+{
+    m_flushScheduled = false;
+    const PackedInt64Array nodes = drain();
+    if (nodes.is_empty() || !m_callback.is_valid())
+    {
+        return;
+    }
+    Array argument_array = Array();
+    argument_array.append(nodes);
+    m_callback.callv(argument_array);
+}
+
+PackedInt64Array FlexDirtiedQueue::drain(void)
+{
+    PackedInt64Array nodes;
+    nodes.resize(m_pending.size());
+    int64_t *out = nodes.ptrw();
+    int count = 0;
+    for (const uint64_t id : m_pending)
+    {
+        Flexbox *node = Object::cast_to<Flexbox>(ObjectDB::get_instance(id));
+        if (node != nullptr)
+        {
+            node->m_dirtiedPending = false;
+            out[count++] = static_cast<int64_t>(id);
+        }
+    }
+    m_pending.clear();
+    nodes.resize(count);
+    return nodes;
+}
+
+int FlexDirtiedQueue::get_pending_count(void) const
+{
+    return static_cast<int>(m_pending.size());
+}
+
+void FlexDirtiedQueue::_bind_methods()
+{
+    ClassDB::bind_method(D_METHOD("set_callback"), &FlexDirtiedQueue::set_callback);
+    ClassDB::bind_method(D_METHOD("get_callback"), &FlexDirtiedQueue::get_callback);
+    ClassDB::bind_method(D_METHOD("flush"), &FlexDirtiedQueue::flush);
+    ClassDB::bind_method(D_METHOD("drain"), &FlexDirtiedQueue::drain);
+    ClassDB::bind_method(D_METHOD("get_pending_count"), &FlexDirtiedQueue::get_pending_count);
+}
@@ -0,0 +1,50 @@
+#ifndef FLEX_DIRTIED_QUEUE_CLASS_H
+#define FLEX_DIRTIED_QUEUE_CLASS_H
+
+#include <godot_cpp/classes/object.hpp>
+#include <godot_cpp/variant/callable.hpp>
+
+#include <vector>
+
+using namespace godot;
+
+class Flexbox;
+
+// Collects the Flexbox nodes dirtied since the last flush, for nodes with
+// set_dirtied_queued(true), and hands them to one callback per frame as a
+// PackedInt64Array of instance ids instead of one script call per node.
+// Registered as the "FlexDirtiedQueue" engine singleton, main thread only.
+class FlexDirtiedQueue : public Object
+{
+    GDCLASS(FlexDirtiedQueue, Object);
+
+protected:
+    static void _bind_methods();
+
+public:
+    static void initialize(void);
+    static void uninitialize(void);
+    static FlexDirtiedQueue *get_singleton(void);
+
+    // Adds the node once per flush and schedules a deferred flush.
+    void push(Flexbox *node);
+
+    // Called with the drained ids, skipped when nothing was dirtied.
+    void set_callback(const Callable &callback);
+    Callable get_callback(void) const;
+    // Drains the queue and calls the callback now.
+    void flush(void);
+    // Drains the queue without calling the callback. Nodes freed meanwhile
+    // are left out.
+    PackedInt64Array drain(void);
+    int get_pending_count(void) const;
+
+private:
+    static FlexDirtiedQueue *singleton;
+
+    Callable m_callback;
+    std::vector<uint64_t> m_pending;
+    bool m_flushScheduled = false;
+};
+
+#endif
@@ -0,0 +1,177 @@
+#include "flex_layout_cache.h"
+
+#include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/core/error_macros.hpp>
+
+#include <cstring>
+
+using namespace godot;
+
+static uint64_t hashBytes(uint64_t hash, const void *data, size_t size)
+{
+    const uint8_t *bytes = static_cast<const uint8_t *>(data);
+    for (size_t i = 0; i < size; i++)
+    {
+        hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+int64_t FlexLayoutCache::make_key(Flexbox *root, double width, double height, int direction) const
+{
+    ERR_FAIL_NULL_V(root, 0);
+    ERR_FAIL_COND_V_MSG(root->has_measure_funcs(), 0, "Trees with measure funcs cannot be cached.");
+
+    const int64_t treeHash = root->get_tree_hash();
+    const float values[3] = {
+        static_cast<float>(width),
+        static_cast<float>(height),
+        YGConfigGetPointScaleFactor(YGNodeGetConfig(root->m_node)),
+    };
+    uint64_t hash = hashBytes(static_cast<uint64_t>(treeHash), values, sizeof(values));
+    hash = hashBytes(hash, &direction, sizeof(direction));
+    return static_cast<int64_t>(hash);
+}
+
+bool FlexLayoutCache::has_layout(int64_t key) const
+{
+    return m_entries.has(key);
+}
+
+PackedFloat32Array FlexLayoutCache::get_layout(int64_t key) const
+{
+    return m_entries.get(key, PackedFloat32Array());
+}
+
+void FlexLayoutCache::store_layout(int64_t key, const PackedFloat32Array &layouts)
+{
+    if (!m_entries.has(key))
+    {
+        if (m_entries.size() >= m_maxEntries && !m_order.empty())
+        {
+            m_entries.erase(m_order.front());
+            m_order.pop_front();
+        }
+        m_order.push_back(key);
+    }
+    m_entries[key] = layouts;
+    emit_changed();
+}
+
+void FlexLayoutCache::clear(void)
+{
+    m_entries.clear();
+    m_order.clear();
+    m_hits = 0;
+    m_misses = 0;
+    emit_changed();
+}
+
+bool FlexLayoutCache::calculate_layout(Flexbox *root, double width, double height, int direction)
+{
+    ERR_FAIL_NULL_V(root, false);
+
+    if (root->has_measure_funcs())
+    {
+        root->calculate_layout(width, height, direction);
+        return false;
+    }
+    const int64_t key = make_key(root, width, height, direction);
+    if (m_entries.has(key))
+    {
+        // Rects of every node, then their details.
+        const PackedFloat32Array entry = m_entries[key];
+        const int64_t count = entry.size() / (4 + Flexbox::LAYOUT_DETAIL_COUNT);
+        if (entry.size() == count * (4 + Flexbox::LAYOUT_DETAIL_COUNT) &&
+            root->apply_layout_packed(entry.slice(0, count * 4), entry.slice(count * 4, entry.size())))
+        {
+            m_hits++;
+            return true;
+        }
+    }
+    m_misses++;
+    if (!m_recording)
+    {
+        root->calculate_layout(width, height, direction);
+        return false;
+    }
+    PackedFloat32Array entry = root->calculate_layout_packed(width, height, direction);
+    entry.append_array(root->get_layout_details_packed());
+    store_layout(key, entry);
+    return false;
+}
+
+int64_t FlexLayoutCache::get_hits(void) const
+{
+    return m_hits;
+}
+
+int64_t FlexLayoutCache::get_misses(void) const
+{
+    return m_misses;
+}
+
+void FlexLayoutCache::set_max_entries(int maxEntries)
+{
+    ERR_FAIL_COND(maxEntries < 1);
+    m_maxEntries = maxEntries;
+    while (m_entries.size() > m_maxEntries && !m_order.empty())
+    {
+        m_entries.erase(m_order.front());
+        m_order.pop_front();
+    }
+}
+
+int FlexLayoutCache::get_max_entries(void) const
+{
+    return m_maxEntries;
+}
+
+void FlexLayoutCache::set_recording(bool recording)
+{
+    m_recording = recording;
+}
+
+bool FlexLayoutCache::is_recording(void) const
+{
+    return m_recording;
+}
+
+void FlexLayoutCache::set_entries(const Dictionary &entries)
+{
+    m_entries = entries;
+    // Dictionaries keep insertion order, the first key is the oldest.
+    const Array keys = m_entries.keys();
+    m_order.clear();
+    for (int64_t i = 0; i < keys.size(); i++)
+    {
+        m_order.push_back(keys[i]);
+    }
+}
+
+Dictionary FlexLayoutCache::get_entries(void) const
+{
+    return m_entries;
+}
+
+void FlexLayoutCache::_bind_methods()
+{
+    ClassDB::bind_method(D_METHOD("make_key"), &FlexLayoutCache::make_key);
+    ClassDB::bind_method(D_METHOD("has_layout"), &FlexLayoutCache::has_layout);
+    ClassDB::bind_method(D_METHOD("get_layout"), &FlexLayoutCache::get_layout);
+    ClassDB::bind_method(D_METHOD("store_layout"), &FlexLayoutCache::store_layout);
+    ClassDB::bind_method(D_METHOD("clear"), &FlexLayoutCache::clear);
+    ClassDB::bind_method(D_METHOD("calculate_layout"), &FlexLayoutCache::calculate_layout);
+    ClassDB::bind_method(D_METHOD("get_hits"), &FlexLayoutCache::get_hits);
+    ClassDB::bind_method(D_METHOD("get_misses"), &FlexLayoutCache::get_misses);
+    ClassDB::bind_method(D_METHOD("set_max_entries"), &FlexLayoutCache::set_max_entries);
+    ClassDB::bind_method(D_METHOD("get_max_entries"), &FlexLayoutCache::get_max_entries);
+    ClassDB::bind_method(D_METHOD("set_recording"), &FlexLayoutCache::set_recording);
+    ClassDB::bind_method(D_METHOD("is_recording"), &FlexLayoutCache::is_recording);
+    ClassDB::bind_method(D_METHOD("set_entries"), &FlexLayoutCache::set_entries);
+    ClassDB::bind_method(D_METHOD("get_entries"), &FlexLayoutCache::get_entries);
+
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "max_entries", PROPERTY_HINT_RANGE, "1,1024,1"), "set_max_entries", "get_max_entries");
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "recording", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_EDITOR), "set_recording", "is_recording");
+    ADD_PROPERTY(PropertyInfo(Variant::DICTIONARY, "entries", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_STORAGE), "set_entries", "get_entries");
+}
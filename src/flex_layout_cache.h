@@ -0,0 +1,62 @@
+#ifndef FLEX_LAYOUT_CACHE_CLASS_H
+#define FLEX_LAYOUT_CACHE_CLASS_H
+
+#include <godot_cpp/classes/resource.hpp>
+#include <godot_cpp/variant/dictionary.hpp>
+
+#include <deque>
+
+#include "flexbox.h"
+
+using namespace godot;
+
+// Computed rects of whole trees, saved with the resource so screens whose
+// layout only depends on their styles and size skip Yoga when loaded again.
+// Keys cover the styles and structure of the tree, the available size, the
+// direction and the point scale factor. What measure funcs return is not part
+// of them, so trees with measure funcs are never cached.
+// Layouts are only stored on request: store_layout(), or misses of
+// calculate_layout() while recording, which is not saved so caches are filled
+// in the editor and only read in game.
+class FlexLayoutCache : public Resource
+{
+    GDCLASS(FlexLayoutCache, Resource);
+
+protected:
+    static void _bind_methods();
+
+public:
+    int64_t make_key(Flexbox *root, double width, double height, int direction) const;
+    bool has_layout(int64_t key) const;
+    PackedFloat32Array get_layout(int64_t key) const;
+    // Drops the oldest entry when the cache is full.
+    void store_layout(int64_t key, const PackedFloat32Array &layouts);
+    void clear(void);
+
+    // Applies the stored layout of root, or lays it out and stores the
+    // result when recording. Returns true on a hit.
+    bool calculate_layout(Flexbox *root, double width, double height, int direction);
+    int64_t get_hits(void) const;
+    int64_t get_misses(void) const;
+
+public: // Properties
+    void set_max_entries(int maxEntries);
+    int get_max_entries(void) const;
+    void set_recording(bool recording);
+    bool is_recording(void) const;
+    // key -> calculate_layout_packed() result followed by
+    // get_layout_details_packed()
+    void set_entries(const Dictionary &entries);
+    Dictionary get_entries(void) const;
+
+private:
+    Dictionary m_entries;
+    // Keys of m_entries, oldest first.
+    std::deque<int64_t> m_order;
+    int m_maxEntries = 16;
+    bool m_recording = false;
+    int64_t m_hits = 0;
+    int64_t m_misses = 0;
+};
+
+#endif
@@ -0,0 +1,151 @@
+#include "flex_profiler.h"
+
+#include <godot_cpp/classes/engine.hpp>
+#include <godot_cpp/classes/engine_debugger.hpp>
+#include <godot_cpp/classes/os.hpp>
+#include <godot_cpp/classes/performance.hpp>
+#include <godot_cpp/classes/time.hpp>
+#include <godot_cpp/core/class_db.hpp>
+
+#include <atomic>
+#include "flexbox.h"
+#include "yoga/Yoga.h"
+#include "yoga/event/event.h"
+
+using namespace godot;
+using facebook::yoga::Event;
+using facebook::yoga::LayoutData;
+
+FlexProfiler *FlexProfiler::singleton = nullptr;
+
+static const char *kMonitorNames[FlexProfiler::COUNTER_MAX] = {
+    "flexbox/layout_passes",
+    "flexbox/nodes_laid_out",
+    "flexbox/cache_hits",
+    "flexbox/cache_misses",
+    "flexbox/measure_callbacks",
+    "flexbox/layout_usec",
+    "flexbox/measure_usec",
+};
+
+// Layout may run on worker threads, so counters are atomic and the pass
+// timers are per thread.
+static std::atomic<int64_t> s_current[FlexProfiler::COUNTER_MAX];
+static int64_t s_last[FlexProfiler::COUNTER_MAX];
+static uint64_t s_frame = 0;
+static thread_local uint64_t t_passStart = 0;
+static thread_local uint64_t t_measureStart = 0;
+
+static void count(FlexProfiler::Counter counter, int64_t value)
+{
+    s_current[counter].fetch_add(value, std::memory_order_relaxed);
+}
+
+static void sendPass(const YGNode &node, uint64_t usec, const LayoutData &data)
+{
+    EngineDebugger *debugger = EngineDebugger::get_singleton();
+    OS *os = OS::get_singleton();
+    if (!debugger->is_active() || os->get_thread_caller_id() != os->get_main_thread_id())
+    {
+        return;
+    }
+    // Flexbox roots report their instance id, FlexTree and bare Yoga roots 0.
+    const Object *root = Flexbox::fromAnyYGNode(const_cast<YGNodeRef>(&node));
+    Array message;
+    message.push_back(root != nullptr ? root->get_instance_id() : 0);
+    message.push_back(usec);
+    message.push_back(data.layouts);
+    message.push_back(data.cachedLayouts + data.cachedMeasures);
+    message.push_back(data.measureCallbacks);
+    debugger->send_message("flexbox:pass", message);
+}
+
+static void onLayoutEvent(const YGNode &node, Event::Type type, Event::Data data)
+{
+    switch (type)
+    {
+    case Event::LayoutPassStart:
+        t_passStart = Time::get_singleton()->get_ticks_usec();
+        break;
+    case Event::LayoutPassEnd:
+    {
+        const LayoutData &layoutData = *data.get<Event::LayoutPassEnd>().layoutData;
+        const uint64_t usec = Time::get_singleton()->get_ticks_usec() - t_passStart;
+        count(FlexProfiler::COUNTER_PASSES, 1);
+        count(FlexProfiler::COUNTER_NODES, layoutData.layouts);
+        count(FlexProfiler::COUNTER_CACHE_HITS, layoutData.cachedLayouts + layoutData.cachedMeasures);
+        count(FlexProfiler::COUNTER_CACHE_MISSES, layoutData.layouts + layoutData.measures);
+        count(FlexProfiler::COUNTER_MEASURE_CALLBACKS, layoutData.measureCallbacks);
+        count(FlexProfiler::COUNTER_LAYOUT_USEC, usec);
+        sendPass(node, usec, layoutData);
+        break;
+    }
+    case Event::MeasureCallbackStart:
+        t_measureStart = Time::get_singleton()->get_ticks_usec();
+        break;
+    case Event::MeasureCallbackEnd:
+        count(FlexProfiler::COUNTER_MEASURE_USEC, Time::get_singleton()->get_ticks_usec() - t_measureStart);
+        break;
+    default:
+        break;
+    }
+}
+
+void FlexProfiler::initialize(void)
+{
+    if (!OS::get_singleton()->is_debug_build())
+    {
+        return;
+    }
+    singleton = memnew(FlexProfiler);
+    Event::subscribe(onLayoutEvent);
+
+    Performance *performance = Performance::get_singleton();
+    for (int i = 0; i < COUNTER_MAX; i++)
+    {
+        Array args;
+        args.push_back(i);
+        performance->add_custom_monitor(kMonitorNames[i], Callable(singleton, "get_monitor"), args);
+    }
+}
+
+void FlexProfiler::uninitialize(void)
+{
+    if (singleton == nullptr)
+    {
+        return;
+    }
+    Performance *performance = Performance::get_singleton();
+    for (int i = 0; i < COUNTER_MAX; i++)
+    {
+        if (performance->has_custom_monitor(kMonitorNames[i]))
+        {
+            performance->remove_custom_monitor(kMonitorNames[i]);
+        }
+    }
+    Event::reset();
+    memdelete(singleton);
+    singleton = nullptr;
+}
+
+int64_t FlexProfiler::get_monitor(int counter)
+{
+    ERR_FAIL_INDEX_V(counter, COUNTER_MAX, 0);
+    // Monitors are polled once per frame, the first poll of a frame closes
+    // the previous one.
+    const uint64_t frame = Engine::get_singleton()->get_process_frames();
+    if (frame != s_frame)
+    {
+        for (int i = 0; i < COUNTER_MAX; i++)
+        {
+            s_last[i] = s_current[i].exchange(0, std::memory_order_relaxed);
+        }
+        s_frame = frame;
+    }
+    return s_last[counter];
+}
+
+void FlexProfiler::_bind_methods()
+{
+    ClassDB::bind_method(D_METHOD("get_monitor", "counter"), &FlexProfiler::get_monitor);
+}
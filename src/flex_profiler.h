@@ -0,0 +1,42 @@
+#ifndef FLEX_PROFILER_CLASS_H
+#define FLEX_PROFILER_CLASS_H
+
+#include <godot_cpp/classes/object.hpp>
+
+using namespace godot;
+
+// Subscribes to Yoga layout events in debug builds and publishes them as
+// Performance custom monitors under "flexbox/", plus one "flexbox:pass"
+// debugger message per layout pass for attributing spikes to a root, listed
+// by the Flexbox tab the editor plugin adds to the debugger.
+class FlexProfiler : public Object
+{
+    GDCLASS(FlexProfiler, Object);
+
+protected:
+    static void _bind_methods();
+
+public:
+    enum Counter
+    {
+        COUNTER_PASSES,
+        COUNTER_NODES,
+        COUNTER_CACHE_HITS,
+        COUNTER_CACHE_MISSES,
+        COUNTER_MEASURE_CALLBACKS,
+        COUNTER_LAYOUT_USEC,
+        COUNTER_MEASURE_USEC,
+        COUNTER_MAX,
+    };
+
+    static void initialize(void);
+    static void uninitialize(void);
+
+    // Value of the counter over the last completed frame.
+    int64_t get_monitor(int counter);
+
+private:
+    static FlexProfiler *singleton;
+};
+
+#endif
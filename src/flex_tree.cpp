@@ -0,0 +1,353 @@
+#include "flex_tree.h"
+
+#include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/core/error_macros.hpp>
+
+using namespace godot;
+
+// Handle: slot generation in the high 32 bits, slot index in the low ones.
+static int64_t makeHandle(uint32_t index, uint32_t generation)
+{
+    return (static_cast<int64_t>(generation) << 32) | index;
+}
+
+FlexTree::FlexTree()
+{
+    m_arena = YGNodeArenaNew();
+    m_config = YGConfigNew();
+    YGConfigSetNodeArena(m_config, m_arena);
+}
+
+FlexTree::~FlexTree()
+{
+    // Freeing the arena drops the nodes still alive.
+    YGConfigFree(m_config);
+    YGNodeArenaFree(m_arena);
+}
+
+//====================================================
+YGNodeRef FlexTree::_get_node(int64_t node) const
+{
+    const uint64_t index = static_cast<uint64_t>(node) & 0xffffffff;
+    const uint32_t generation = static_cast<uint32_t>(static_cast<uint64_t>(node) >> 32);
+    if (node < 0 || index >= m_slots.size() || m_slots[index].generation != generation)
+    {
+        return nullptr;
+    }
+    return m_slots[index].node;
+}
+
+int64_t FlexTree::_get_handle(YGNodeRef nodeRef) const
+{
+    const Slot *slot = static_cast<const Slot *>(YGNodeGetContext(nodeRef));
+    return makeHandle(slot->index, slot->generation);
+}
+
+// YGNodeFree unlinks a node from its parent without dirtying it.
+void FlexTree::_detach(YGNodeRef nodeRef)
+{
+    const YGNodeRef owner = YGNodeGetOwner(nodeRef);
+    if (owner != nullptr)
+    {
+        YGNodeRemoveChild(owner, nodeRef);
+    }
+}
+
+void FlexTree::_free_slot(YGNodeRef nodeRef)
+{
+    Slot *slot = static_cast<Slot *>(YGNodeGetContext(nodeRef));
+    YGNodeFree(nodeRef);
+    slot->node = nullptr;
+    slot->generation++;
+    m_freeSlots.push_back(slot->index);
+    m_nodeCount--;
+}
+
+int64_t FlexTree::create_node(void)
+{
+    uint32_t index;
+    if (m_freeSlots.empty())
+    {
+        index = static_cast<uint32_t>(m_slots.size());
+        m_slots.emplace_back();
+        m_slots.back().index = index;
+    }
+    else
+    {
+        index = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    }
+    const YGNodeRef nodeRef = YGNodeNewWithConfig(m_config);
+    YGNodeSetContext(nodeRef, &m_slots[index]);
+    m_slots[index].node = nodeRef;
+    m_nodeCount++;
+    return makeHandle(index, m_slots[index].generation);
+}
+
+void FlexTree::free_node(int64_t node)
+{
+    const YGNodeRef nodeRef = _get_node(node);
+    ERR_FAIL_NULL_MSG(nodeRef, "Invalid FlexTree node.");
+    _detach(nodeRef);
+    _free_slot(nodeRef);
+}
+
+void FlexTree::free_subtree(int64_t node)
+{
+    const YGNodeRef nodeRef = _get_node(node);
+    ERR_FAIL_NULL_MSG(nodeRef, "Invalid FlexTree node.");
+    _detach(nodeRef);
+
+    std::vector<YGNodeRef> pending = {nodeRef};
+    while (!pending.empty())
+    {
+        const YGNodeRef current = pending.back();
+        pending.pop_back();
+        const uint32_t childCount = YGNodeGetChildCount(current);
+        for (uint32_t i = 0; i < childCount; i++)
+        {
+            pending.push_back(YGNodeGetChild(current, i));
+        }
+        _free_slot(current);
+    }
+}
+
+void FlexTree::clear(void)
+{
+    // Every node comes from the arena, resetting it drops them all without
+    // unlinking them from each other one by one.
+    m_freeSlots.clear();
+    for (Slot &slot : m_slots)
+    {
+        if (slot.node != nullptr)
+        {
+            slot.node = nullptr;
+            slot.generation++;
+        }
+        m_freeSlots.push_back(slot.index);
+    }
+    m_nodeCount = 0;
+    YGNodeArenaReset(m_arena);
+}
+
+bool FlexTree::is_valid(int64_t node) const
+{
+    return _get_node(node) != nullptr;
+}
+
+int FlexTree::get_node_count(void) const
+{
+    return m_nodeCount;
+}
+
+PackedInt64Array FlexTree::build_tree(const PackedInt32Array &parents, const PackedByteArray &styles, const PackedInt32Array &styleRanges)
+{
+    const int count = parents.size();
+    const int recordCount = styles.size() / Flexbox::STYLE_RECORD_SIZE;
+    ERR_FAIL_COND_V_MSG(styles.size() % Flexbox::STYLE_RECORD_SIZE != 0, PackedInt64Array(), "Packed style size must be a multiple of STYLE_RECORD_SIZE.");
+    ERR_FAIL_COND_V_MSG(!styleRanges.is_empty() && styleRanges.size() != count * 2, PackedInt64Array(), "Style ranges need a start and a count per node.");
+
+    // Everything is checked up front so bad input creates no nodes.
+    const int32_t *parent = parents.ptr();
+    const int32_t *range = styleRanges.ptr();
+    for (int i = 0; i < count; i++)
+    {
+        ERR_FAIL_COND_V_MSG(parent[i] < -1 || parent[i] >= i, PackedInt64Array(), "Parent indices must point to an earlier node or be -1.");
+        if (range != nullptr)
+        {
+            const int start = range[i * 2];
+            const int length = range[i * 2 + 1];
+            ERR_FAIL_COND_V_MSG(start < 0 || length < 0 || length > recordCount - start, PackedInt64Array(), "Style range out of bounds.");
+        }
+    }
+
+    PackedInt64Array handles;
+    handles.resize(count);
+    int64_t *handle = handles.ptrw();
+    std::vector<YGNodeRef> nodes(count);
+    const uint8_t *records = styles.ptr();
+    for (int i = 0; i < count; i++)
+    {
+        handle[i] = create_node();
+        nodes[i] = _get_node(handle[i]);
+        if (range != nullptr && range[i * 2 + 1] > 0)
+        {
+            const uint8_t *first = records + static_cast<size_t>(range[i * 2]) * Flexbox::STYLE_RECORD_SIZE;
+            Flexbox::applyStyleRecords(nodes[i], first, first + static_cast<size_t>(range[i * 2 + 1]) * Flexbox::STYLE_RECORD_SIZE);
+        }
+    }
+
+    // Children grouped by parent in index order, each list set in one call.
+    std::vector<int> firstChild(count + 1, 0);
+    for (int i = 0; i < count; i++)
+    {
+        if (parent[i] >= 0)
+        {
+            firstChild[parent[i] + 1]++;
+        }
+    }
+    for (int i = 0; i < count; i++)
+    {
+        firstChild[i + 1] += firstChild[i];
+    }
+    std::vector<YGNodeRef> children(firstChild[count]);
+    std::vector<int> filled(firstChild.begin(), firstChild.end() - 1);
+    for (int i = 0; i < count; i++)
+    {
+        if (parent[i] >= 0)
+        {
+            children[filled[parent[i]]++] = nodes[i];
+        }
+    }
+    for (int i = 0; i < count; i++)
+    {
+        const int childCount = firstChild[i + 1] - firstChild[i];
+        if (childCount > 0)
+        {
+            YGNodeSetChildren(nodes[i], children.data() + firstChild[i], childCount);
+        }
+    }
+    return handles;
+}
+
+//====================================================
+void FlexTree::insert_child(int64_t parent, int64_t child, int index)
+{
+    const YGNodeRef parentRef = _get_node(parent);
+    const YGNodeRef childRef = _get_node(child);
+    ERR_FAIL_COND_MSG(parentRef == nullptr || childRef == nullptr, "Invalid FlexTree node.");
+    ERR_FAIL_COND_MSG(YGNodeGetOwner(childRef) != nullptr, "FlexTree node already has a parent.");
+    for (YGNodeRef ancestor = parentRef; ancestor != nullptr; ancestor = YGNodeGetOwner(ancestor))
+    {
+        ERR_FAIL_COND_MSG(ancestor == childRef, "FlexTree node cannot be inserted under itself or its descendants.");
+    }
+    ERR_FAIL_INDEX(index, static_cast<int>(YGNodeGetChildCount(parentRef)) + 1);
+    YGNodeInsertChild(parentRef, childRef, index);
+}
+
+void FlexTree::remove_child(int64_t parent, int64_t child)
+{
+    const YGNodeRef parentRef = _get_node(parent);
+    const YGNodeRef childRef = _get_node(child);
+    ERR_FAIL_COND_MSG(parentRef == nullptr || childRef == nullptr, "Invalid FlexTree node.");
+    YGNodeRemoveChild(parentRef, childRef);
+}
+
+int FlexTree::get_child_count(int64_t node) const
+{
+    const YGNodeRef nodeRef = _get_node(node);
+    ERR_FAIL_NULL_V_MSG(nodeRef, 0, "Invalid FlexTree node.");
+    return YGNodeGetChildCount(nodeRef);
+}
+
+int64_t FlexTree::get_child(int64_t node, int index) const
+{
+    const YGNodeRef nodeRef = _get_node(node);
+    ERR_FAIL_NULL_V_MSG(nodeRef, -1, "Invalid FlexTree node.");
+    ERR_FAIL_INDEX_V(index, static_cast<int>(YGNodeGetChildCount(nodeRef)), -1);
+    return _get_handle(YGNodeGetChild(nodeRef, index));
+}
+
+int64_t FlexTree::get_parent(int64_t node) const
+{
+    const YGNodeRef nodeRef = _get_node(node);
+    ERR_FAIL_NULL_V_MSG(nodeRef, -1, "Invalid FlexTree node.");
+    const YGNodeRef owner = YGNodeGetOwner(nodeRef);
+    return owner != nullptr ? _get_handle(owner) : -1;
+}
+
+//====================================================
+void FlexTree::set_style(int64_t node, int property, const Variant &value)
+{
+    const YGNodeRef nodeRef = _get_node(node);
+    ERR_FAIL_NULL_MSG(nodeRef, "Invalid FlexTree node.");
+    Flexbox::setStyle(nodeRef, property, value);
+}
+
+void FlexTree::apply_style(int64_t node, const Dictionary &style)
+{
+    const YGNodeRef nodeRef = _get_node(node);
+    ERR_FAIL_NULL_MSG(nodeRef, "Invalid FlexTree node.");
+    Flexbox::applyStyle(nodeRef, style);
+}
+
+void FlexTree::apply_style_packed(int64_t node, const PackedByteArray &style)
+{
+    const YGNodeRef nodeRef = _get_node(node);
+    ERR_FAIL_NULL_MSG(nodeRef, "Invalid FlexTree node.");
+    Flexbox::applyStylePacked(nodeRef, style);
+}
+
+//====================================================
+void FlexTree::calculate_layout(int64_t root, double width, double height, int direction)
+{
+    const YGNodeRef rootRef = _get_node(root);
+    ERR_FAIL_NULL_MSG(rootRef, "Invalid FlexTree node.");
+    YGNodeCalculateLayout(rootRef, width, height, static_cast<YGDirection>(direction));
+}
+
+bool FlexTree::needs_layout(int64_t root) const
+{
+    const YGNodeRef rootRef = _get_node(root);
+    ERR_FAIL_NULL_V_MSG(rootRef, false, "Invalid FlexTree node.");
+    return YGNodeNeedsLayout(rootRef);
+}
+
+Rect2 FlexTree::get_layout(int64_t node) const
+{
+    const YGNodeRef nodeRef = _get_node(node);
+    ERR_FAIL_NULL_V_MSG(nodeRef, Rect2(), "Invalid FlexTree node.");
+    return Rect2(
+        YGNodeLayoutGetLeft(nodeRef),
+        YGNodeLayoutGetTop(nodeRef),
+        YGNodeLayoutGetWidth(nodeRef),
+        YGNodeLayoutGetHeight(nodeRef));
+}
+
+PackedFloat32Array FlexTree::get_layouts_packed(int64_t root) const
+{
+    const YGNodeRef rootRef = _get_node(root);
+    ERR_FAIL_NULL_V_MSG(rootRef, PackedFloat32Array(), "Invalid FlexTree node.");
+
+    // A first pass without storage only counts the nodes.
+    YGLayoutBuffer buffer = {};
+    YGNodeCopyLayoutToBuffer(rootRef, &buffer);
+    const uint32_t count = buffer.count;
+
+    PackedFloat32Array layouts;
+    layouts.resize(count * 4);
+    float *out = layouts.ptrw();
+    buffer.left = out;
+    buffer.top = out + count;
+    buffer.width = out + count * 2;
+    buffer.height = out + count * 3;
+    buffer.capacity = count;
+    YGNodeCopyLayoutToBuffer(rootRef, &buffer);
+    return layouts;
+}
+
+void FlexTree::_bind_methods()
+{
+    ClassDB::bind_method(D_METHOD("create_node"), &FlexTree::create_node);
+    ClassDB::bind_method(D_METHOD("free_node"), &FlexTree::free_node);
+    ClassDB::bind_method(D_METHOD("free_subtree"), &FlexTree::free_subtree);
+    ClassDB::bind_method(D_METHOD("clear"), &FlexTree::clear);
+    ClassDB::bind_method(D_METHOD("is_valid"), &FlexTree::is_valid);
+    ClassDB::bind_method(D_METHOD("get_node_count"), &FlexTree::get_node_count);
+    ClassDB::bind_method(D_METHOD("build_tree"), &FlexTree::build_tree);
+
+    ClassDB::bind_method(D_METHOD("insert_child"), &FlexTree::insert_child);
+    ClassDB::bind_method(D_METHOD("remove_child"), &FlexTree::remove_child);
+    ClassDB::bind_method(D_METHOD("get_child_count"), &FlexTree::get_child_count);
+    ClassDB::bind_method(D_METHOD("get_child"), &FlexTree::get_child);
+    ClassDB::bind_method(D_METHOD("get_parent"), &FlexTree::get_parent);
+
+    ClassDB::bind_method(D_METHOD("set_style"), &FlexTree::set_style);
+    ClassDB::bind_method(D_METHOD("apply_style"), &FlexTree::apply_style);
+    ClassDB::bind_method(D_METHOD("apply_style_packed"), &FlexTree::apply_style_packed);
+
+    ClassDB::bind_method(D_METHOD("calculate_layout"), &FlexTree::calculate_layout);
+    ClassDB::bind_method(D_METHOD("needs_layout"), &FlexTree::needs_layout);
+    ClassDB::bind_method(D_METHOD("get_layout"), &FlexTree::get_layout);
+    ClassDB::bind_method(D_METHOD("get_layouts_packed"), &FlexTree::get_layouts_packed);
+}
@@ -0,0 +1,86 @@
+#ifndef FLEX_TREE_CLASS_H
+#define FLEX_TREE_CLASS_H
+
+#include <godot_cpp/classes/ref_counted.hpp>
+#include <godot_cpp/variant/dictionary.hpp>
+#include <godot_cpp/variant/rect2.hpp>
+
+#include <deque>
+#include <vector>
+#include "flexbox.h"
+
+using namespace godot;
+
+// Pool of Yoga nodes addressed by integer handles, for trees that do not need
+// a Flexbox object per node. Nodes come from an arena of the tree and share
+// its config. Handles of freed nodes stay invalid even once their slot is
+// reused. Measure and dirtied funcs are not supported.
+class FlexTree : public RefCounted
+{
+    GDCLASS(FlexTree, RefCounted);
+
+protected:
+    static void _bind_methods();
+
+public:
+    FlexTree();
+    ~FlexTree();
+
+public: // Node pool
+    int64_t create_node(void);
+    // Detaches the node from its parent, its children become roots.
+    void free_node(int64_t node);
+    void free_subtree(int64_t node);
+    void clear(void);
+    bool is_valid(int64_t node) const;
+    int get_node_count(void) const;
+    // Creates parents.size() nodes at once, node i is a child of node
+    // parents[i], which must come before it, or a root for -1. Node i gets
+    // styleRanges[2 * i + 1] records of styles from record styleRanges[2 * i],
+    // so nodes can share a style. Returns the handles in the same order.
+    PackedInt64Array build_tree(const PackedInt32Array &parents, const PackedByteArray &styles, const PackedInt32Array &styleRanges);
+
+public: // Tree hierarchy
+    void insert_child(int64_t parent, int64_t child, int index);
+    void remove_child(int64_t parent, int64_t child);
+    int get_child_count(int64_t node) const;
+    int64_t get_child(int64_t node, int index) const;
+    // -1 for roots.
+    int64_t get_parent(int64_t node) const;
+
+public: // Style, properties and values as in Flexbox.apply_style()
+    void set_style(int64_t node, int property, const Variant &value);
+    void apply_style(int64_t node, const Dictionary &style);
+    void apply_style_packed(int64_t node, const PackedByteArray &style);
+
+public: // Layout
+    void calculate_layout(int64_t root, double width, double height, int direction);
+    bool needs_layout(int64_t root) const;
+    Rect2 get_layout(int64_t node) const;
+    // [left * n, top * n, width * n, height * n] of the subtree in pre-order,
+    // root first, positions relative to the parent.
+    PackedFloat32Array get_layouts_packed(int64_t root) const;
+
+private:
+    // Nodes point their Yoga context at their slot, a deque keeps it in
+    // place as the pool grows.
+    struct Slot
+    {
+        YGNodeRef node = nullptr;
+        uint32_t generation = 1;
+        uint32_t index = 0;
+    };
+
+    YGNodeRef _get_node(int64_t node) const;
+    int64_t _get_handle(YGNodeRef nodeRef) const;
+    void _detach(YGNodeRef nodeRef);
+    void _free_slot(YGNodeRef nodeRef);
+
+    YGConfigRef m_config;
+    YGNodeArenaRef m_arena;
+    std::deque<Slot> m_slots;
+    std::vector<uint32_t> m_freeSlots;
+    uint32_t m_nodeCount = 0;
+};
+
+#endif
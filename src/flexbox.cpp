@@ -1,7 +1,15 @@
 #include "flexbox.h"
+#include "flex_dirtied_queue.h"
 
 #include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/core/error_macros.hpp>
+#include <godot_cpp/variant/callable_method_pointer.hpp>
 #include <godot_cpp/variant/utility_functions.hpp>
+#include <godot_cpp/classes/worker_thread_pool.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include "yoga/YGNode.h"
 
 using namespace godot;
 //
@@ -13,6 +21,11 @@ static Variant fromYGValue(YGValue const &ygValue)
     return value;
 }
 
+static Vector2 toVector2(YGValue const &ygValue)
+{
+    return Vector2(ygValue.value, static_cast<float>(ygValue.unit));
+}
+
 static YGSize globalMeasureFunc(
     YGNodeRef nodeRef,
     float width,
@@ -22,11 +35,499 @@ static YGSize globalMeasureFunc(
 {
     Flexbox &node = *reinterpret_cast<Flexbox *>(YGNodeGetContext(nodeRef));
 
-    const Dictionary &size = node.call_measure_func(width, widthMode, height, heightMode);
-    Variant w = size["width"];
-    Variant h = size["height"];
-    YGSize ygSize = {static_cast<float>(w), static_cast<float>(h)};
-    return ygSize;
+    return node.measure(width, widthMode, height, heightMode);
+}
+
+// Intrinsic size constrained the way Yoga expects a measure func to answer.
+static float constrainMeasuredSize(float intrinsic, float available, YGMeasureMode mode)
+{
+    switch (mode)
+    {
+    case YGMeasureModeExactly:
+        return available;
+    case YGMeasureModeAtMost:
+        return intrinsic < available ? intrinsic : available;
+    default:
+        return intrinsic;
+    }
+}
+
+static uint32_t countDescendants(YGNodeRef nodeRef)
+{
+    const uint32_t childCount = YGNodeGetChildCount(nodeRef);
+    uint32_t count = childCount;
+    for (uint32_t i = 0; i < childCount; i++)
+    {
+        count += countDescendants(YGNodeGetChild(nodeRef, i));
+    }
+    return count;
+}
+
+static float *writeLayout(YGNodeRef nodeRef, float *out)
+{
+    out[0] = YGNodeLayoutGetLeft(nodeRef);
+    out[1] = YGNodeLayoutGetTop(nodeRef);
+    out[2] = YGNodeLayoutGetWidth(nodeRef);
+    out[3] = YGNodeLayoutGetHeight(nodeRef);
+    return out + 4;
+}
+
+// [left * n, top * n, width * n, height * n]
+static void setLayoutArrays(YGLayoutBuffer &buffer, float *layouts, uint32_t count)
+{
+    buffer.left = layouts;
+    buffer.top = layouts + count;
+    buffer.width = layouts + count * 2;
+    buffer.height = layouts + count * 3;
+}
+
+// Float blocks of get_layout_details_packed(), the direction and overflow
+// blocks are converted by the caller.
+static void setDetailArrays(YGLayoutBuffer &buffer, float *details, uint32_t count)
+{
+    buffer.right = details + count * 2;
+    buffer.bottom = details + count * 3;
+    for (uint32_t edge = 0; edge < 4; edge++)
+    {
+        buffer.margin[edge] = details + count * (4 + edge);
+        buffer.border[edge] = details + count * (8 + edge);
+        buffer.padding[edge] = details + count * (12 + edge);
+    }
+}
+
+//====================batch style============================
+static const struct
+{
+    const char *name;
+    int property;
+} kStyleNames[] = {
+    {"position_type", Flexbox::STYLE_POSITION_TYPE},
+    {"position", Flexbox::STYLE_POSITION},
+    {"align_content", Flexbox::STYLE_ALIGN_CONTENT},
+    {"align_items", Flexbox::STYLE_ALIGN_ITEMS},
+    {"align_self", Flexbox::STYLE_ALIGN_SELF},
+    {"flex_direction", Flexbox::STYLE_FLEX_DIRECTION},
+    {"flex_wrap", Flexbox::STYLE_FLEX_WRAP},
+    {"justify_content", Flexbox::STYLE_JUSTIFY_CONTENT},
+    {"margin", Flexbox::STYLE_MARGIN},
+    {"overflow", Flexbox::STYLE_OVERFLOW},
+    {"display", Flexbox::STYLE_DISPLAY},
+    {"flex", Flexbox::STYLE_FLEX},
+    {"flex_basis", Flexbox::STYLE_FLEX_BASIS},
+    {"flex_grow", Flexbox::STYLE_FLEX_GROW},
+    {"flex_shrink", Flexbox::STYLE_FLEX_SHRINK},
+    {"width", Flexbox::STYLE_WIDTH},
+    {"height", Flexbox::STYLE_HEIGHT},
+    {"min_width", Flexbox::STYLE_MIN_WIDTH},
+    {"min_height", Flexbox::STYLE_MIN_HEIGHT},
+    {"max_width", Flexbox::STYLE_MAX_WIDTH},
+    {"max_height", Flexbox::STYLE_MAX_HEIGHT},
+    {"aspect_ratio", Flexbox::STYLE_ASPECT_RATIO},
+    {"border", Flexbox::STYLE_BORDER},
+    {"padding", Flexbox::STYLE_PADDING},
+    {"gap", Flexbox::STYLE_GAP},
+    // Keys written by the FlexContainer child inspector.
+    {"basis", Flexbox::STYLE_FLEX_BASIS},
+    {"grow", Flexbox::STYLE_FLEX_GROW},
+    {"shrink", Flexbox::STYLE_FLEX_SHRINK},
+};
+
+// Same edge order as the child inspector: top, right, bottom, left.
+static const YGEdge kStyleEdges[4] = {YGEdgeTop, YGEdgeRight, YGEdgeBottom, YGEdgeLeft};
+
+// Style edits are applied to this detached node and copied back in one go,
+// so the target only runs markDirtyAndPropogate once. Main thread only.
+static YGNodeRef styleScratchNode(YGNodeRef nodeRef)
+{
+    static YGNodeRef scratch = YGNodeNew();
+    YGNodeCopyStyle(scratch, nodeRef);
+    return scratch;
+}
+
+static float pointValue(YGUnit unit, float value)
+{
+    return unit == YGUnitPoint ? value : YGUndefined;
+}
+
+// Number of values of an enum-valued property, 0 for the others.
+static int styleEnumCount(int property)
+{
+    using facebook::yoga::enums::count;
+    switch (property)
+    {
+    case Flexbox::STYLE_POSITION_TYPE:
+        return count<YGPositionType>();
+    case Flexbox::STYLE_ALIGN_CONTENT:
+    case Flexbox::STYLE_ALIGN_ITEMS:
+    case Flexbox::STYLE_ALIGN_SELF:
+        return count<YGAlign>();
+    case Flexbox::STYLE_FLEX_DIRECTION:
+        return count<YGFlexDirection>();
+    case Flexbox::STYLE_FLEX_WRAP:
+        return count<YGWrap>();
+    case Flexbox::STYLE_JUSTIFY_CONTENT:
+        return count<YGJustify>();
+    case Flexbox::STYLE_OVERFLOW:
+        return count<YGOverflow>();
+    case Flexbox::STYLE_DISPLAY:
+        return count<YGDisplay>();
+    }
+    return 0;
+}
+
+static void applyStyleValue(YGNodeRef node, int property, int edge, YGUnit unit, float value)
+{
+    // Gutters and edges index fixed-size arrays of the style.
+    const int edgeMax = property == Flexbox::STYLE_GAP ? static_cast<int>(YGGutterAll) : static_cast<int>(YGEdgeAll);
+    if (edge < 0 || edge > edgeMax)
+    {
+        ERR_PRINT("Invalid style edge or gutter.");
+        return;
+    }
+    const int enumCount = styleEnumCount(property);
+    if (enumCount > 0 && !(value >= 0 && value < enumCount))
+    {
+        ERR_PRINT("Style enum value out of range.");
+        return;
+    }
+
+    const YGEdge ygEdge = static_cast<YGEdge>(edge);
+    switch (property)
+    {
+    case Flexbox::STYLE_POSITION_TYPE:
+        YGNodeStyleSetPositionType(node, static_cast<YGPositionType>(static_cast<int>(value)));
+        break;
+    case Flexbox::STYLE_POSITION:
+        if (unit == YGUnitPercent)
+        {
+            YGNodeStyleSetPositionPercent(node, ygEdge, value);
+        }
+        else
+        {
+            YGNodeStyleSetPosition(node, ygEdge, pointValue(unit, value));
+        }
+        break;
+    case Flexbox::STYLE_ALIGN_CONTENT:
+        YGNodeStyleSetAlignContent(node, static_cast<YGAlign>(static_cast<int>(value)));
+        break;
+    case Flexbox::STYLE_ALIGN_ITEMS:
+        YGNodeStyleSetAlignItems(node, static_cast<YGAlign>(static_cast<int>(value)));
+        break;
+    case Flexbox::STYLE_ALIGN_SELF:
+        YGNodeStyleSetAlignSelf(node, static_cast<YGAlign>(static_cast<int>(value)));
+        break;
+    case Flexbox::STYLE_FLEX_DIRECTION:
+        YGNodeStyleSetFlexDirection(node, static_cast<YGFlexDirection>(static_cast<int>(value)));
+        break;
+    case Flexbox::STYLE_FLEX_WRAP:
+        YGNodeStyleSetFlexWrap(node, static_cast<YGWrap>(static_cast<int>(value)));
+        break;
+    case Flexbox::STYLE_JUSTIFY_CONTENT:
+        YGNodeStyleSetJustifyContent(node, static_cast<YGJustify>(static_cast<int>(value)));
+        break;
+    case Flexbox::STYLE_MARGIN:
+        if (unit == YGUnitAuto)
+        {
+            YGNodeStyleSetMarginAuto(node, ygEdge);
+        }
+        else if (unit == YGUnitPercent)
+        {
+            YGNodeStyleSetMarginPercent(node, ygEdge, value);
+        }
+        else
+        {
+            YGNodeStyleSetMargin(node, ygEdge, pointValue(unit, value));
+        }
+        break;
+    case Flexbox::STYLE_OVERFLOW:
+        YGNodeStyleSetOverflow(node, static_cast<YGOverflow>(static_cast<int>(value)));
+        break;
+    case Flexbox::STYLE_DISPLAY:
+        YGNodeStyleSetDisplay(node, static_cast<YGDisplay>(static_cast<int>(value)));
+        break;
+    case Flexbox::STYLE_FLEX:
+        YGNodeStyleSetFlex(node, pointValue(unit, value));
+        break;
+    case Flexbox::STYLE_FLEX_BASIS:
+        if (unit == YGUnitAuto)
+        {
+            YGNodeStyleSetFlexBasisAuto(node);
+        }
+        else if (unit == YGUnitPercent)
+        {
+            YGNodeStyleSetFlexBasisPercent(node, value);
+        }
+        else
+        {
+            YGNodeStyleSetFlexBasis(node, pointValue(unit, value));
+        }
+        break;
+    case Flexbox::STYLE_FLEX_GROW:
+        YGNodeStyleSetFlexGrow(node, pointValue(unit, value));
+        break;
+    case Flexbox::STYLE_FLEX_SHRINK:
+        YGNodeStyleSetFlexShrink(node, pointValue(unit, value));
+        break;
+    case Flexbox::STYLE_WIDTH:
+        if (unit == YGUnitAuto)
+        {
+            YGNodeStyleSetWidthAuto(node);
+        }
+        else if (unit == YGUnitPercent)
+        {
+            YGNodeStyleSetWidthPercent(node, value);
+        }
+        else
+        {
+            YGNodeStyleSetWidth(node, pointValue(unit, value));
+        }
+        break;
+    case Flexbox::STYLE_HEIGHT:
+        if (unit == YGUnitAuto)
+        {
+            YGNodeStyleSetHeightAuto(node);
+        }
+        else if (unit == YGUnitPercent)
+        {
+            YGNodeStyleSetHeightPercent(node, value);
+        }
+        else
+        {
+            YGNodeStyleSetHeight(node, pointValue(unit, value));
+        }
+        break;
+    case Flexbox::STYLE_MIN_WIDTH:
+        if (unit == YGUnitPercent)
+        {
+            YGNodeStyleSetMinWidthPercent(node, value);
+        }
+        else
+        {
+            YGNodeStyleSetMinWidth(node, pointValue(unit, value));
+        }
+        break;
+    case Flexbox::STYLE_MIN_HEIGHT:
+        if (unit == YGUnitPercent)
+        {
+            YGNodeStyleSetMinHeightPercent(node, value);
+        }
+        else
+        {
+            YGNodeStyleSetMinHeight(node, pointValue(unit, value));
+        }
+        break;
+    case Flexbox::STYLE_MAX_WIDTH:
+        if (unit == YGUnitPercent)
+        {
+            YGNodeStyleSetMaxWidthPercent(node, value);
+        }
+        else
+        {
+            YGNodeStyleSetMaxWidth(node, pointValue(unit, value));
+        }
+        break;
+    case Flexbox::STYLE_MAX_HEIGHT:
+        if (unit == YGUnitPercent)
+        {
+            YGNodeStyleSetMaxHeightPercent(node, value);
+        }
+        else
+        {
+            YGNodeStyleSetMaxHeight(node, pointValue(unit, value));
+        }
+        break;
+    case Flexbox::STYLE_ASPECT_RATIO:
+        YGNodeStyleSetAspectRatio(node, pointValue(unit, value));
+        break;
+    case Flexbox::STYLE_BORDER:
+        YGNodeStyleSetBorder(node, ygEdge, pointValue(unit, value));
+        break;
+    case Flexbox::STYLE_PADDING:
+        if (unit == YGUnitPercent)
+        {
+            YGNodeStyleSetPaddingPercent(node, ygEdge, value);
+        }
+        else
+        {
+            YGNodeStyleSetPadding(node, ygEdge, pointValue(unit, value));
+        }
+        break;
+    case Flexbox::STYLE_GAP:
+        YGNodeStyleSetGap(node, static_cast<YGGutter>(edge), pointValue(unit, value));
+        break;
+    }
+}
+
+// Numbers are points, "auto" is auto, "50%" is a percentage, null is undefined.
+static void parseStyleValue(const Variant &variant, YGUnit &unit, float &value)
+{
+    switch (variant.get_type())
+    {
+    case Variant::NIL:
+        unit = YGUnitUndefined;
+        value = YGUndefined;
+        break;
+    case Variant::STRING:
+    {
+        const String text = String(variant).strip_edges();
+        if (text == "auto")
+        {
+            unit = YGUnitAuto;
+            value = YGUndefined;
+        }
+        else if (text.ends_with("%"))
+        {
+            unit = YGUnitPercent;
+            value = text.substr(0, text.length() - 1).to_float();
+        }
+        else
+        {
+            unit = YGUnitPoint;
+            value = text.to_float();
+        }
+        break;
+    }
+    default:
+        unit = YGUnitPoint;
+        value = variant;
+        break;
+    }
+}
+
+static void applyStyleVariant(YGNodeRef node, int property, const Variant &variant)
+{
+    YGUnit unit;
+    float value;
+    const bool isEdgeProperty = property == Flexbox::STYLE_POSITION ||
+                                property == Flexbox::STYLE_MARGIN ||
+                                property == Flexbox::STYLE_BORDER ||
+                                property == Flexbox::STYLE_PADDING;
+    if (isEdgeProperty && variant.get_type() == Variant::ARRAY)
+    {
+        const Array edges = variant;
+        for (int i = 0; i < 4 && i < edges.size(); i++)
+        {
+            parseStyleValue(edges[i], unit, value);
+            applyStyleValue(node, property, kStyleEdges[i], unit, value);
+        }
+        return;
+    }
+    if (property == Flexbox::STYLE_GAP && variant.get_type() == Variant::ARRAY)
+    {
+        // [row, column], the CSS gap shorthand order.
+        const Array gutters = variant;
+        const YGGutter order[2] = {YGGutterRow, YGGutterColumn};
+        for (int i = 0; i < 2 && i < gutters.size(); i++)
+        {
+            parseStyleValue(gutters[i], unit, value);
+            applyStyleValue(node, property, order[i], unit, value);
+        }
+        return;
+    }
+    parseStyleValue(variant, unit, value);
+    const int edge = property == Flexbox::STYLE_GAP ? static_cast<int>(YGGutterAll) : static_cast<int>(YGEdgeAll);
+    applyStyleValue(node, property, edge, unit, value);
+}
+
+/* static */
+void Flexbox::applyStyleRecords(YGNodeRef node, const uint8_t *record, const uint8_t *end)
+{
+    for (; record < end; record += Flexbox::STYLE_RECORD_SIZE)
+    {
+        float value;
+        memcpy(&value, record + 4, sizeof(float)); // little-endian, as written by encode_float
+        if (record[0] >= Flexbox::STYLE_PROPERTY_MAX || record[2] > YGUnitAuto)
+        {
+            ERR_PRINT("Invalid packed style record.");
+            continue;
+        }
+        applyStyleValue(node, record[0], record[1], static_cast<YGUnit>(record[2]), value);
+    }
+}
+
+static void appendStyleRecord(std::vector<uint8_t> &out, int property, int edge, YGUnit unit, float value)
+{
+    uint8_t record[Flexbox::STYLE_RECORD_SIZE] = {
+        static_cast<uint8_t>(property),
+        static_cast<uint8_t>(edge),
+        static_cast<uint8_t>(unit),
+        0,
+    };
+    memcpy(record + 4, &value, sizeof(float));
+    out.insert(out.end(), record, record + Flexbox::STYLE_RECORD_SIZE);
+}
+
+// Appends the records that turn a default style into this one when applied
+// in order, returns how many were written. With allFields every field gets a
+// record whatever its value, always in the same order, see STYLE_FIXED_SIZE.
+static uint32_t writeStyleRecords(const YGStyle &style, std::vector<uint8_t> &out, bool allFields = false)
+{
+    using facebook::yoga::detail::CompactValue;
+    static const YGStyle defaults;
+    const size_t start = out.size();
+
+    const auto enumRecord = [&out, allFields](int property, int value, int defaultValue) {
+        if (allFields || value != defaultValue)
+        {
+            appendStyleRecord(out, property, 0, YGUnitPoint, static_cast<float>(value));
+        }
+    };
+    const auto floatRecord = [&out, allFields](int property, YGFloatOptional value) {
+        if (!value.isUndefined())
+        {
+            appendStyleRecord(out, property, 0, YGUnitPoint, value.unwrap());
+        }
+        else if (allFields)
+        {
+            appendStyleRecord(out, property, 0, YGUnitUndefined, YGUndefined);
+        }
+    };
+    const auto valueRecord = [&out, allFields](int property, int edge, CompactValue value, CompactValue defaultValue) {
+        if (allFields || !(value == defaultValue))
+        {
+            const YGValue ygValue = value;
+            appendStyleRecord(out, property, edge, ygValue.unit, ygValue.value);
+        }
+    };
+
+    enumRecord(Flexbox::STYLE_POSITION_TYPE, style.positionType(), defaults.positionType());
+    enumRecord(Flexbox::STYLE_ALIGN_CONTENT, style.alignContent(), defaults.alignContent());
+    enumRecord(Flexbox::STYLE_ALIGN_ITEMS, style.alignItems(), defaults.alignItems());
+    enumRecord(Flexbox::STYLE_ALIGN_SELF, style.alignSelf(), defaults.alignSelf());
+    enumRecord(Flexbox::STYLE_FLEX_DIRECTION, style.flexDirection(), defaults.flexDirection());
+    enumRecord(Flexbox::STYLE_FLEX_WRAP, style.flexWrap(), defaults.flexWrap());
+    enumRecord(Flexbox::STYLE_JUSTIFY_CONTENT, style.justifyContent(), defaults.justifyContent());
+    enumRecord(Flexbox::STYLE_OVERFLOW, style.overflow(), defaults.overflow());
+    enumRecord(Flexbox::STYLE_DISPLAY, style.display(), defaults.display());
+
+    floatRecord(Flexbox::STYLE_FLEX, style.flex());
+    floatRecord(Flexbox::STYLE_FLEX_GROW, style.flexGrow());
+    floatRecord(Flexbox::STYLE_FLEX_SHRINK, style.flexShrink());
+    floatRecord(Flexbox::STYLE_ASPECT_RATIO, style.aspectRatio());
+    valueRecord(Flexbox::STYLE_FLEX_BASIS, 0, style.flexBasis(), defaults.flexBasis());
+
+    for (int edge = 0; edge <= YGEdgeAll; edge++)
+    {
+        const YGEdge ygEdge = static_cast<YGEdge>(edge);
+        valueRecord(Flexbox::STYLE_POSITION, edge, style.position()[ygEdge], defaults.position()[ygEdge]);
+        valueRecord(Flexbox::STYLE_MARGIN, edge, style.margin()[ygEdge], defaults.margin()[ygEdge]);
+        valueRecord(Flexbox::STYLE_PADDING, edge, style.padding()[ygEdge], defaults.padding()[ygEdge]);
+        valueRecord(Flexbox::STYLE_BORDER, edge, style.border()[ygEdge], defaults.border()[ygEdge]);
+    }
+    for (int gutter = 0; gutter <= YGGutterAll; gutter++)
+    {
+        const YGGutter ygGutter = static_cast<YGGutter>(gutter);
+        valueRecord(Flexbox::STYLE_GAP, gutter, style.gap()[ygGutter], defaults.gap()[ygGutter]);
+    }
+
+    valueRecord(Flexbox::STYLE_WIDTH, 0, style.dimensions()[YGDimensionWidth], defaults.dimensions()[YGDimensionWidth]);
+    valueRecord(Flexbox::STYLE_HEIGHT, 0, style.dimensions()[YGDimensionHeight], defaults.dimensions()[YGDimensionHeight]);
+    valueRecord(Flexbox::STYLE_MIN_WIDTH, 0, style.minDimensions()[YGDimensionWidth], defaults.minDimensions()[YGDimensionWidth]);
+    valueRecord(Flexbox::STYLE_MIN_HEIGHT, 0, style.minDimensions()[YGDimensionHeight], defaults.minDimensions()[YGDimensionHeight]);
+    valueRecord(Flexbox::STYLE_MAX_WIDTH, 0, style.maxDimensions()[YGDimensionWidth], defaults.maxDimensions()[YGDimensionWidth]);
+    valueRecord(Flexbox::STYLE_MAX_HEIGHT, 0, style.maxDimensions()[YGDimensionHeight], defaults.maxDimensions()[YGDimensionHeight]);
+
+    return static_cast<uint32_t>((out.size() - start) / Flexbox::STYLE_RECORD_SIZE);
 }
 
 static void globalDirtiedFunc(YGNodeRef nodeRef)
@@ -35,6 +536,21 @@ static void globalDirtiedFunc(YGNodeRef nodeRef)
 
     node.call_dirtied_func();
 }
+
+static void queuedDirtiedFunc(YGNodeRef nodeRef)
+{
+    Flexbox &node = *reinterpret_cast<Flexbox *>(YGNodeGetContext(nodeRef));
+
+    FlexDirtiedQueue *queue = FlexDirtiedQueue::get_singleton();
+    if (queue != nullptr)
+    {
+        queue->push(&node);
+    }
+    else if (node.m_dirtiedFunc != nullptr)
+    {
+        node.call_dirtied_func();
+    }
+}
 /* static */
 // Flexbox *Flexbox::create()
 // {
@@ -56,14 +572,42 @@ static void globalDirtiedFunc(YGNodeRef nodeRef)
 //     YGNodeSetContext(m_node, reinterpret_cast<void *>(this));
 // }
 //
+// Flexbox nodes use this config or a copy of it. Its context tells them
+// apart from other Yoga nodes, whose context may not be a Flexbox.
+static char s_flexboxConfigTag;
+
+static YGConfigRef flexboxConfig(void)
+{
+    static const YGConfigRef config = [] {
+        const YGConfigRef newConfig = YGConfigNew();
+        YGConfigSetContext(newConfig, &s_flexboxConfigTag);
+        return newConfig;
+    }();
+    return config;
+}
+
 Flexbox::Flexbox()
 {
-    m_node = YGNodeNew();
+    m_node = YGNodeNewWithConfig(flexboxConfig());
     YGNodeSetContext(m_node, reinterpret_cast<void *>(this));
 }
 Flexbox::~Flexbox()
 {
+    if (m_async.task >= 0)
+    {
+        WorkerThreadPool::get_singleton()->wait_for_task_completion(m_async.task);
+        YGNodeFreeRecursive(m_async.snapshot);
+    }
     YGNodeFree(m_node);
+    if (m_config != nullptr)
+    {
+        YGConfigFree(m_config);
+    }
+    // Held children still referenced by scripts outlive this node.
+    for (const Ref<Flexbox> &child : m_treeChildren)
+    {
+        child->m_treeHolder = nullptr;
+    }
 }
 
 //====================================================
@@ -73,6 +617,15 @@ Flexbox *Flexbox::fromYGNode(YGNodeRef nodeRef)
     return reinterpret_cast<Flexbox *>(YGNodeGetContext(nodeRef));
 }
 /* static */
+Flexbox *Flexbox::fromAnyYGNode(YGNodeRef nodeRef)
+{
+    if (YGConfigGetContext(YGNodeGetConfig(nodeRef)) != &s_flexboxConfigTag)
+    {
+        return nullptr;
+    }
+    return fromYGNode(nodeRef);
+}
+/* static */
 void Flexbox::destroy(Flexbox *node)
 {
     //nothing to do
@@ -80,8 +633,13 @@ void Flexbox::destroy(Flexbox *node)
 void Flexbox::reset(void)
 {
     m_measureFunc.reset(nullptr);
+    m_measureKind = MEASURE_NONE;
+    m_measureControl = 0;
+    clear_measure_cache();
     m_dirtiedFunc.reset(nullptr);
+    m_dirtiedQueued = false;
     YGNodeReset(m_node);
+    YGNodeSetContext(m_node, reinterpret_cast<void *>(this));
 }
 
 void Flexbox::copy_style(Flexbox *other)
@@ -89,6 +647,53 @@ void Flexbox::copy_style(Flexbox *other)
     YGNodeCopyStyle(m_node, other->m_node);
 }
 
+void Flexbox::apply_style(const Dictionary &style)
+{
+    applyStyle(m_node, style);
+}
+
+void Flexbox::apply_style_packed(const PackedByteArray &style)
+{
+    applyStylePacked(m_node, style);
+}
+
+/* static */
+void Flexbox::applyStyle(YGNodeRef nodeRef, const Dictionary &style)
+{
+    const YGNodeRef scratch = styleScratchNode(nodeRef);
+    const Array keys = style.keys();
+    for (int i = 0; i < keys.size(); i++)
+    {
+        const String key = keys[i];
+        for (const auto &entry : kStyleNames)
+        {
+            if (key == entry.name)
+            {
+                applyStyleVariant(scratch, entry.property, style[keys[i]]);
+                break;
+            }
+        }
+    }
+    YGNodeCopyStyle(nodeRef, scratch);
+}
+
+/* static */
+void Flexbox::applyStylePacked(YGNodeRef nodeRef, const PackedByteArray &style)
+{
+    ERR_FAIL_COND_MSG(style.size() % STYLE_RECORD_SIZE != 0, "Packed style size must be a multiple of STYLE_RECORD_SIZE.");
+
+    const YGNodeRef scratch = styleScratchNode(nodeRef);
+    applyStyleRecords(scratch, style.ptr(), style.ptr() + style.size());
+    YGNodeCopyStyle(nodeRef, scratch);
+}
+
+/* static */
+void Flexbox::setStyle(YGNodeRef nodeRef, int property, const Variant &value)
+{
+    ERR_FAIL_INDEX(property, STYLE_PROPERTY_MAX);
+    applyStyleVariant(nodeRef, property, value);
+}
+
 void Flexbox::set_position_type(int positionType)
 {
     YGNodeStyleSetPositionType(m_node, static_cast<YGPositionType>(positionType));
@@ -413,14 +1018,203 @@ float Flexbox::get_gap(int gutter)
 }
 //
 
+//====================typed getter============================
+Vector2 Flexbox::get_position_vector2(int edge) const
+{
+    return toVector2(YGNodeStyleGetPosition(m_node, static_cast<YGEdge>(edge)));
+}
+
+Vector2 Flexbox::get_margin_vector2(int edge) const
+{
+    return toVector2(YGNodeStyleGetMargin(m_node, static_cast<YGEdge>(edge)));
+}
+
+Vector2 Flexbox::get_flex_basis_vector2(void) const
+{
+    return toVector2(YGNodeStyleGetFlexBasis(m_node));
+}
+
+Vector2 Flexbox::get_width_vector2(void) const
+{
+    return toVector2(YGNodeStyleGetWidth(m_node));
+}
+
+Vector2 Flexbox::get_height_vector2(void) const
+{
+    return toVector2(YGNodeStyleGetHeight(m_node));
+}
+
+Vector2 Flexbox::get_min_width_vector2(void) const
+{
+    return toVector2(YGNodeStyleGetMinWidth(m_node));
+}
+
+Vector2 Flexbox::get_min_height_vector2(void) const
+{
+    return toVector2(YGNodeStyleGetMinHeight(m_node));
+}
+
+Vector2 Flexbox::get_max_width_vector2(void) const
+{
+    return toVector2(YGNodeStyleGetMaxWidth(m_node));
+}
+
+Vector2 Flexbox::get_max_height_vector2(void) const
+{
+    return toVector2(YGNodeStyleGetMaxHeight(m_node));
+}
+
+Vector2 Flexbox::get_padding_vector2(int edge) const
+{
+    return toVector2(YGNodeStyleGetPadding(m_node, static_cast<YGEdge>(edge)));
+}
+
+PackedByteArray Flexbox::get_style_packed(void) const
+{
+    std::vector<uint8_t> out;
+    writeStyleRecords(m_node->getStyle(), out);
+    PackedByteArray style;
+    style.resize(out.size());
+    memcpy(style.ptrw(), out.data(), out.size());
+    return style;
+}
+
+PackedByteArray Flexbox::get_style_fixed_packed(void) const
+{
+    std::vector<uint8_t> out;
+    out.reserve(STYLE_FIXED_SIZE);
+    writeStyleRecords(m_node->getStyle(), out, true);
+    ERR_FAIL_COND_V(out.size() != static_cast<size_t>(STYLE_FIXED_SIZE), PackedByteArray());
+    PackedByteArray style;
+    style.resize(out.size());
+    memcpy(style.ptrw(), out.data(), out.size());
+    return style;
+}
+
+/* static */
+int Flexbox::get_style_fixed_offset(int property, int edge)
+{
+    // The records of a default style give the position of every field.
+    static const std::vector<uint8_t> fixed = [] {
+        std::vector<uint8_t> out;
+        writeStyleRecords(YGStyle(), out, true);
+        return out;
+    }();
+    for (size_t offset = 0; offset < fixed.size(); offset += STYLE_RECORD_SIZE)
+    {
+        if (fixed[offset] == property && fixed[offset + 1] == edge)
+        {
+            return static_cast<int>(offset);
+        }
+    }
+    return -1;
+}
+
 void Flexbox::insert_child(Flexbox *child, unsigned index)
 {
     YGNodeInsertChild(m_node, child->m_node, index);
+    _hold_tree_child(child);
 }
 
 void Flexbox::remove_child(Flexbox *child)
 {
     YGNodeRemoveChild(m_node, child->m_node);
+    _release_tree_child(child);
+}
+
+// Nodes created by deserialize_tree() are held by the Flexbox they are a
+// child of, the hold moves along when they are inserted elsewhere.
+void Flexbox::_hold_tree_child(Flexbox *child)
+{
+    Flexbox *holder = child->m_treeHolder;
+    if (holder == nullptr || holder == this)
+    {
+        return;
+    }
+    const Ref<Flexbox> ref(child);
+    holder->_release_tree_child(child);
+    m_treeChildren.push_back(ref);
+    child->m_treeHolder = this;
+}
+
+// May free the child.
+void Flexbox::_release_tree_child(Flexbox *child)
+{
+    if (child->m_treeHolder != this)
+    {
+        return;
+    }
+    child->m_treeHolder = nullptr;
+    for (auto it = m_treeChildren.begin(); it != m_treeChildren.end(); ++it)
+    {
+        if (it->ptr() == child)
+        {
+            m_treeChildren.erase(it);
+            return;
+        }
+    }
+}
+
+void Flexbox::_release_tree_children(void)
+{
+    for (const Ref<Flexbox> &child : m_treeChildren)
+    {
+        child->m_treeHolder = nullptr;
+    }
+    m_treeChildren.clear();
+}
+
+void Flexbox::set_children(const Array &children)
+{
+    ERR_FAIL_COND_MSG(YGNodeHasMeasureFunc(m_node) && !children.is_empty(), "A Flexbox node with a measure func cannot have children.");
+
+    // Parentless children can only close a cycle if they are the root of
+    // this tree, the other ancestors all have a parent.
+    YGNodeRef treeRoot = m_node;
+    while (YGNodeGetOwner(treeRoot) != nullptr)
+    {
+        treeRoot = YGNodeGetOwner(treeRoot);
+    }
+
+    std::vector<YGNodeRef> nodes;
+    nodes.reserve(children.size());
+    for (int i = 0; i < children.size(); i++)
+    {
+        const Flexbox *child = Object::cast_to<Flexbox>(children[i]);
+        ERR_FAIL_NULL_MSG(child, "set_children() takes an array of Flexbox nodes.");
+        const YGNodeRef owner = YGNodeGetOwner(child->m_node);
+        ERR_FAIL_COND_MSG(owner != nullptr && owner != m_node, "Flexbox node already has another parent.");
+        ERR_FAIL_COND_MSG(child->m_node == treeRoot, "A Flexbox node cannot be a child of itself or its descendants.");
+        nodes.push_back(child->m_node);
+    }
+    std::vector<YGNodeRef> sorted = nodes;
+    std::sort(sorted.begin(), sorted.end());
+    ERR_FAIL_COND_MSG(std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end(), "Flexbox node listed twice.");
+
+    YGNodeSetChildren(m_node, nodes);
+    for (const YGNodeRef node : nodes)
+    {
+        _hold_tree_child(fromYGNode(node));
+    }
+    // Children from deserialize_tree() that were dropped are released.
+    for (const Ref<Flexbox> &child : m_treeChildren)
+    {
+        if (YGNodeGetOwner(child->m_node) != m_node)
+        {
+            child->m_treeHolder = nullptr;
+        }
+    }
+    m_treeChildren.erase(
+        std::remove_if(m_treeChildren.begin(), m_treeChildren.end(), [this](const Ref<Flexbox> &child) {
+            return child->m_treeHolder != this;
+        }),
+        m_treeChildren.end());
+}
+
+void Flexbox::remove_all_children(void)
+{
+    YGNodeRemoveAllChildren(m_node);
+    _release_tree_children();
 }
 
 unsigned Flexbox::get_child_count(void) const
@@ -449,12 +1243,541 @@ Flexbox *Flexbox::get_child(unsigned index)
     }
     return Flexbox::fromYGNode(nodePtr);
 }
+
+//====================tree snapshot============================
+// Little-endian blob:
+//   header:   char[4] "FLXT", u32 version, u32 flags, u32 node count
+//   per node, in pre-order:
+//             u32 child count, u16 style record count, u8 node flags, u8 0,
+//             style records as read by apply_style_packed(),
+//             f32 left, top, width, height if TREE_LAYOUTS is set
+static const char kTreeMagic[4] = {'F', 'L', 'X', 'T'};
+static const uint32_t kTreeVersion = 1;
+static const uint32_t kTreeHeaderSize = 16;
+static const uint32_t kTreeNodeHeaderSize = 8;
+
+enum TreeFlags : uint32_t
+{
+    TREE_LAYOUTS = 1 << 0,
+};
+
+enum TreeNodeFlags : uint8_t
+{
+    TREE_NODE_REFERENCE_BASELINE = 1 << 0,
+    TREE_NODE_TEXT = 1 << 1,
+};
+
+static void writeTreeNode(YGNodeRef node, bool withLayouts, std::vector<uint8_t> &out, uint32_t &nodeCount)
+{
+    const size_t headerAt = out.size();
+    out.resize(headerAt + kTreeNodeHeaderSize);
+    const uint32_t childCount = YGNodeGetChildCount(node);
+    const uint16_t recordCount = static_cast<uint16_t>(writeStyleRecords(node->getStyle(), out));
+    const uint8_t nodeFlags =
+        (node->isReferenceBaseline() ? TREE_NODE_REFERENCE_BASELINE : 0) |
+        (node->getNodeType() == YGNodeTypeText ? TREE_NODE_TEXT : 0);
+    uint8_t *header = out.data() + headerAt;
+    memcpy(header, &childCount, sizeof(childCount));
+    memcpy(header + 4, &recordCount, sizeof(recordCount));
+    header[6] = nodeFlags;
+    header[7] = 0;
+    if (withLayouts)
+    {
+        float layout[4];
+        writeLayout(node, layout);
+        const uint8_t *bytes = reinterpret_cast<const uint8_t *>(layout);
+        out.insert(out.end(), bytes, bytes + sizeof(layout));
+    }
+    nodeCount++;
+    for (uint32_t i = 0; i < childCount; i++)
+    {
+        writeTreeNode(YGNodeGetChild(node, i), withLayouts, out, nodeCount);
+    }
+}
+
+struct TreeReader
+{
+    const uint8_t *ptr;
+    const uint8_t *end;
+
+    const uint8_t *take(size_t size)
+    {
+        if (static_cast<size_t>(end - ptr) < size)
+        {
+            return nullptr;
+        }
+        const uint8_t *bytes = ptr;
+        ptr += size;
+        return bytes;
+    }
+};
+
+// Fills a fresh node, returns false on truncated data.
+static bool readTreeNode(TreeReader &reader, bool withLayouts, YGNodeRef node, uint32_t &childCount)
+{
+    const uint8_t *header = reader.take(kTreeNodeHeaderSize);
+    if (header == nullptr)
+    {
+        return false;
+    }
+    uint16_t recordCount;
+    memcpy(&childCount, header, sizeof(childCount));
+    memcpy(&recordCount, header + 4, sizeof(recordCount));
+    const uint8_t nodeFlags = header[6];
+
+    const uint8_t *records = reader.take(static_cast<size_t>(recordCount) * Flexbox::STYLE_RECORD_SIZE);
+    if (records == nullptr)
+    {
+        return false;
+    }
+    Flexbox::applyStyleRecords(node, records, reader.ptr);
+    YGNodeSetIsReferenceBaseline(node, (nodeFlags & TREE_NODE_REFERENCE_BASELINE) != 0);
+    YGNodeSetNodeType(node, (nodeFlags & TREE_NODE_TEXT) != 0 ? YGNodeTypeText : YGNodeTypeDefault);
+
+    if (withLayouts)
+    {
+        const uint8_t *bytes = reader.take(4 * sizeof(float));
+        if (bytes == nullptr)
+        {
+            return false;
+        }
+        float layout[4];
+        memcpy(layout, bytes, sizeof(layout));
+        node->setLayoutPosition(layout[0], YGEdgeLeft);
+        node->setLayoutPosition(layout[1], YGEdgeTop);
+        node->setLayoutDimension(layout[2], YGDimensionWidth);
+        node->setLayoutDimension(layout[3], YGDimensionHeight);
+        node->setHasNewLayout(true);
+    }
+    return true;
+}
+
+PackedByteArray Flexbox::serialize_tree(bool withLayouts) const
+{
+    std::vector<uint8_t> out;
+    out.reserve(kTreeHeaderSize + (countDescendants(m_node) + 1) * (kTreeNodeHeaderSize + 8 * STYLE_RECORD_SIZE));
+    out.resize(kTreeHeaderSize);
+    uint32_t nodeCount = 0;
+    writeTreeNode(m_node, withLayouts, out, nodeCount);
+
+    const uint32_t flags = withLayouts ? TREE_LAYOUTS : 0;
+    memcpy(out.data(), kTreeMagic, sizeof(kTreeMagic));
+    memcpy(out.data() + 4, &kTreeVersion, sizeof(kTreeVersion));
+    memcpy(out.data() + 8, &flags, sizeof(flags));
+    memcpy(out.data() + 12, &nodeCount, sizeof(nodeCount));
+
+    PackedByteArray data;
+    data.resize(out.size());
+    memcpy(data.ptrw(), out.data(), out.size());
+    return data;
+}
+
+void Flexbox::deserialize_tree(const PackedByteArray &data)
+{
+    TreeReader reader = {data.ptr(), data.ptr() + data.size()};
+    const uint8_t *header = reader.take(kTreeHeaderSize);
+    ERR_FAIL_COND_MSG(header == nullptr || memcmp(header, kTreeMagic, sizeof(kTreeMagic)) != 0, "Not a serialized Flexbox tree.");
+    uint32_t version, flags, nodeCount;
+    memcpy(&version, header + 4, sizeof(version));
+    memcpy(&flags, header + 8, sizeof(flags));
+    memcpy(&nodeCount, header + 12, sizeof(nodeCount));
+    ERR_FAIL_COND_MSG(version != kTreeVersion, "Unsupported Flexbox tree version.");
+    ERR_FAIL_COND_MSG(m_node->hasMeasureFunc() && nodeCount > 1, "A Flexbox with a measure func cannot have children.");
+    const bool withLayouts = (flags & TREE_LAYOUTS) != 0;
+
+    // Built aside and swapped in, so bad data leaves this node untouched.
+    Ref<Flexbox> loaded;
+    loaded.instantiate();
+    uint32_t childCount;
+    ERR_FAIL_COND_MSG(nodeCount == 0 || !readTreeNode(reader, withLayouts, loaded->m_node, childCount), "Truncated Flexbox tree.");
+    uint32_t nodesRead = 1;
+
+    struct Pending
+    {
+        Flexbox *node;
+        uint32_t remaining;
+    };
+    std::vector<Pending> stack;
+    stack.push_back({loaded.ptr(), childCount});
+    while (!stack.empty())
+    {
+        if (stack.back().remaining == 0)
+        {
+            stack.pop_back();
+            continue;
+        }
+        stack.back().remaining--;
+        Flexbox *parent = stack.back().node;
+
+        ERR_FAIL_COND_MSG(nodesRead == nodeCount, "Flexbox tree has more nodes than its header.");
+        Ref<Flexbox> child;
+        child.instantiate();
+        ERR_FAIL_COND_MSG(!readTreeNode(reader, withLayouts, child->m_node, childCount), "Truncated Flexbox tree.");
+        nodesRead++;
+        ERR_FAIL_COND_MSG(childCount > nodeCount - nodesRead, "Flexbox tree has more nodes than its header.");
+
+        YGNodeInsertChild(parent->m_node, child->m_node, YGNodeGetChildCount(parent->m_node));
+        parent->m_treeChildren.push_back(child);
+        child->m_treeHolder = parent;
+        stack.push_back({child.ptr(), childCount});
+    }
+    ERR_FAIL_COND_MSG(nodesRead != nodeCount || reader.ptr != reader.end, "Flexbox tree size does not match its header.");
+
+    YGNodeRemoveAllChildren(m_node);
+    _release_tree_children();
+    // Adopted first, so clearing the old list keeps their restored layouts.
+    const YGVector &children = loaded->m_node->getChildren();
+    YGNodeSetChildren(m_node, children.data(), static_cast<uint32_t>(children.size()));
+    YGNodeRemoveAllChildren(loaded->m_node);
+    m_treeChildren.swap(loaded->m_treeChildren);
+    for (const Ref<Flexbox> &child : m_treeChildren)
+    {
+        child->m_treeHolder = this;
+    }
+
+    YGNodeCopyStyle(m_node, loaded->m_node);
+    YGNodeSetIsReferenceBaseline(m_node, YGNodeIsReferenceBaseline(loaded->m_node));
+    YGNodeSetNodeType(m_node, YGNodeGetNodeType(loaded->m_node));
+    if (withLayouts)
+    {
+        m_node->setLayout(loaded->m_node->getLayout());
+        m_node->setHasNewLayout(true);
+    }
+}
 //
 
 void Flexbox::calculate_layout(double width, double height, int direction)
 {
-    YGNodeCalculateLayout(
-        m_node, width, height, static_cast<YGDirection>(direction));
+    // The originals were marked clean when snapshotted, land that layout
+    // first. This call supersedes any coalesced request.
+    m_async.requeued = false;
+    _finish_async_layout();
+    facebook::yoga::calculateLayoutWithData(
+        m_node, width, height, static_cast<YGDirection>(direction), nullptr, &m_lastLayoutData);
+}
+
+PackedFloat32Array Flexbox::calculate_layout_packed(double width, double height, int direction)
+{
+    calculate_layout(width, height, direction);
+
+    PackedFloat32Array layouts;
+    YGLayoutBuffer buffer = {};
+    for (;;)
+    {
+        const uint32_t capacity = m_packedNodeCount;
+        layouts.resize(capacity * 4);
+        setLayoutArrays(buffer, layouts.ptrw(), capacity);
+        buffer.capacity = capacity;
+        YGNodeCopyLayoutToBuffer(m_node, &buffer);
+        m_packedNodeCount = buffer.count;
+        if (buffer.count == capacity)
+        {
+            return layouts;
+        }
+    }
+}
+
+PackedFloat32Array Flexbox::get_layout_details_packed(void) const
+{
+    const uint32_t count = countDescendants(m_node) + 1;
+    PackedFloat32Array details;
+    details.resize(count * LAYOUT_DETAIL_COUNT);
+    float *out = details.ptrw();
+    std::vector<uint8_t> direction(count);
+    std::vector<uint8_t> hadOverflow(count);
+    YGLayoutBuffer buffer = {};
+    buffer.direction = direction.data();
+    buffer.hadOverflow = hadOverflow.data();
+    setDetailArrays(buffer, out, count);
+    buffer.capacity = count;
+    YGNodeCopyLayoutToBuffer(m_node, &buffer);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        out[i] = direction[i];
+        out[count + i] = hadOverflow[i];
+    }
+    return details;
+}
+
+bool Flexbox::apply_layout_packed(const PackedFloat32Array &layouts, const PackedFloat32Array &details)
+{
+    ERR_FAIL_COND_V_MSG(layouts.size() % 4 != 0, false, "Packed layout size must be a multiple of 4.");
+
+    const uint32_t count = static_cast<uint32_t>(layouts.size() / 4);
+    ERR_FAIL_COND_V_MSG(!details.is_empty() && details.size() != count * LAYOUT_DETAIL_COUNT, false,
+        "Packed layout details must be empty or hold one block per value.");
+    YGLayoutBuffer buffer = {};
+    setLayoutArrays(buffer, const_cast<float *>(layouts.ptr()), count);
+    std::vector<uint8_t> direction;
+    std::vector<uint8_t> hadOverflow;
+    if (!details.is_empty())
+    {
+        const float *in = details.ptr();
+        direction.resize(count);
+        hadOverflow.resize(count);
+        for (uint32_t i = 0; i < count; i++)
+        {
+            // Out of range directions are inherited.
+            direction[i] = in[i] > 0 && in[i] < 256 ? static_cast<uint8_t>(in[i]) : YGDirectionInherit;
+            hadOverflow[i] = in[count + i] != 0;
+        }
+        buffer.direction = direction.data();
+        buffer.hadOverflow = hadOverflow.data();
+        setDetailArrays(buffer, const_cast<float *>(in), count);
+    }
+    buffer.capacity = count;
+    buffer.count = count;
+    if (!YGNodeApplyLayoutFromBuffer(m_node, &buffer))
+    {
+        return false;
+    }
+    m_packedNodeCount = count;
+    return true;
+}
+
+int64_t Flexbox::get_tree_hash(void) const
+{
+    std::vector<uint8_t> tree;
+    uint32_t nodeCount = 0;
+    writeTreeNode(m_node, false, tree, nodeCount);
+
+    // FNV-1a, stable across runs and platforms so hashes can be saved.
+    uint64_t hash = 14695981039346656037ULL;
+    for (const uint8_t byte : tree)
+    {
+        hash = (hash ^ byte) * 1099511628211ULL;
+    }
+    return static_cast<int64_t>(hash);
+}
+
+static bool treeHasMeasureFunc(YGNodeRef node)
+{
+    if (node->hasMeasureFunc())
+    {
+        return true;
+    }
+    for (YGNodeRef child : node->getChildren())
+    {
+        if (treeHasMeasureFunc(child))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool Flexbox::has_measure_funcs(void) const
+{
+    return treeHasMeasureFunc(m_node);
+}
+
+// Detached copy of the subtree, without context or callbacks so the worker
+// never reaches back into Flexbox objects. The originals are marked clean,
+// any edit made while the snapshot is laid out dirties them again.
+static YGNodeRef snapshotTree(YGNodeRef node, std::unordered_map<YGNodeRef, YGNodeRef> &sources)
+{
+    YGNodeRef clone = YGNodeClone(node);
+    clone->setContext(nullptr);
+    clone->setDirtiedFunc(nullptr);
+    sources[clone] = node;
+
+    YGVector children;
+    children.reserve(node->getChildren().size());
+    for (YGNodeRef child : node->getChildren())
+    {
+        YGNodeRef childClone = snapshotTree(child, sources);
+        childClone->setOwner(clone);
+        children.push_back(childClone);
+    }
+    clone->setChildren(children);
+    node->setDirty(false);
+    node->setHasDirtyBoundary(false);
+    return clone;
+}
+
+// Nodes edited meanwhile are dirty and keep their old layout until the next
+// pass, so do children that are no longer the node their snapshot was cloned
+// from. Only pointers of the recorded originals are compared, some may have
+// been freed.
+static void copySnapshotLayout(YGNodeRef node, YGNodeRef snapshot, const std::unordered_map<YGNodeRef, YGNodeRef> &sources)
+{
+    if (node->isDirty())
+    {
+        return;
+    }
+    node->setLayout(snapshot->getLayout());
+    node->setHasNewLayout(snapshot->getHasNewLayout());
+    const YGVector &children = node->getChildren();
+    const YGVector &snapshotChildren = snapshot->getChildren();
+    const size_t childCount = std::min(children.size(), snapshotChildren.size());
+    for (size_t i = 0; i < childCount; i++)
+    {
+        if (sources.at(snapshotChildren[i]) == children[i])
+        {
+            copySnapshotLayout(children[i], snapshotChildren[i], sources);
+        }
+    }
+}
+
+void Flexbox::calculate_layout_async(double width, double height, int direction)
+{
+    if (m_async.task >= 0)
+    {
+        // Coalesced, the latest request runs once the pending one lands.
+        m_async.requeued = true;
+        m_async.nextWidth = width;
+        m_async.nextHeight = height;
+        m_async.nextDirection = static_cast<YGDirection>(direction);
+        return;
+    }
+    if (treeHasMeasureFunc(m_node))
+    {
+        calculate_layout(width, height, direction);
+        call_deferred("emit_signal", "layout_ready");
+        return;
+    }
+    _start_async_layout(width, height, static_cast<YGDirection>(direction));
+}
+
+bool Flexbox::is_layout_pending(void) const
+{
+    return m_async.task >= 0;
+}
+
+void Flexbox::_start_async_layout(float width, float height, YGDirection direction)
+{
+    m_async.snapshot = snapshotTree(m_node, m_async.sources);
+    m_async.width = width;
+    m_async.height = height;
+    m_async.direction = direction;
+    m_async.requeued = false;
+    m_async.task = WorkerThreadPool::get_singleton()->add_native_task(
+        &Flexbox::_run_async_layout, this, false, "Flexbox layout");
+}
+
+/* static */
+void Flexbox::_run_async_layout(void *userdata)
+{
+    Flexbox *self = static_cast<Flexbox *>(userdata);
+    AsyncLayout &async = self->m_async;
+    facebook::yoga::calculateLayoutWithData(
+        async.snapshot, async.width, async.height, async.direction, nullptr, &async.layoutData);
+    callable_mp(self, &Flexbox::_finish_async_layout).call_deferred();
+}
+
+void Flexbox::_finish_async_layout(void)
+{
+    if (m_async.task < 0)
+    {
+        return;
+    }
+    WorkerThreadPool::get_singleton()->wait_for_task_completion(m_async.task);
+    m_async.task = -1;
+
+    copySnapshotLayout(m_node, m_async.snapshot, m_async.sources);
+    m_lastLayoutData = m_async.layoutData;
+    YGNodeFreeRecursive(m_async.snapshot);
+    m_async.snapshot = nullptr;
+    m_async.sources.clear();
+
+    emit_signal("layout_ready");
+    if (m_async.requeued)
+    {
+        calculate_layout_async(m_async.nextWidth, m_async.nextHeight, m_async.nextDirection);
+    }
+}
+
+YGConfigRef Flexbox::_get_own_config(void)
+{
+    if (m_config == nullptr)
+    {
+        m_config = YGConfigNew();
+        YGConfigCopy(m_config, YGNodeGetConfig(m_node));
+        YGNodeSetConfig(m_node, m_config);
+    }
+    return m_config;
+}
+
+void Flexbox::set_parallel_layout(bool enabled)
+{
+    YGConfigSetParallelLayout(_get_own_config(), enabled);
+}
+
+bool Flexbox::get_parallel_layout(void) const
+{
+    return YGConfigGetParallelLayout(YGNodeGetConfig(m_node));
+}
+
+void Flexbox::set_parallel_layout_threshold(int nodeCount)
+{
+    ERR_FAIL_COND(nodeCount < 0);
+    YGConfigSetParallelLayoutThreshold(_get_own_config(), nodeCount);
+}
+
+int Flexbox::get_parallel_layout_threshold(void) const
+{
+    return YGConfigGetParallelLayoutThreshold(YGNodeGetConfig(m_node));
+}
+
+void Flexbox::set_layout_boundary(bool enabled)
+{
+    YGConfigSetLayoutBoundaries(_get_own_config(), enabled);
+}
+
+bool Flexbox::get_layout_boundary(void) const
+{
+    return YGConfigGetLayoutBoundaries(YGNodeGetConfig(m_node));
+}
+
+bool Flexbox::needs_layout(void) const
+{
+    return YGNodeNeedsLayout(m_node);
+}
+
+void Flexbox::set_measurement_cache_size(int size)
+{
+    ERR_FAIL_COND(size < 1);
+    YGConfigSetMeasurementCacheSize(_get_own_config(), size);
+}
+
+int Flexbox::get_measurement_cache_size(void) const
+{
+    return YGConfigGetMeasurementCacheSize(YGNodeGetConfig(m_node));
+}
+
+void Flexbox::set_measurement_cache_policy(int policy)
+{
+    ERR_FAIL_COND(policy != MEASUREMENT_CACHE_FLUSH && policy != MEASUREMENT_CACHE_LRU);
+    YGConfigSetMeasurementCachePolicy(_get_own_config(), static_cast<YGMeasurementCachePolicy>(policy));
+}
+
+int Flexbox::get_measurement_cache_policy(void) const
+{
+    return YGConfigGetMeasurementCachePolicy(YGNodeGetConfig(m_node));
+}
+
+Dictionary Flexbox::get_last_layout_stats(void) const
+{
+    using facebook::yoga::LayoutPassReason;
+    const facebook::yoga::LayoutData &data = m_lastLayoutData;
+
+    Dictionary reasons;
+    for (int i = 0; i < static_cast<int>(LayoutPassReason::COUNT); i++)
+    {
+        reasons[LayoutPassReasonToString(static_cast<LayoutPassReason>(i))] =
+            data.measureCallbackReasonsCount[i];
+    }
+
+    Dictionary stats;
+    stats["layouts"] = data.layouts;
+    stats["measures"] = data.measures;
+    stats["max_measure_cache"] = data.maxMeasureCache;
+    stats["cached_layouts"] = data.cachedLayouts;
+    stats["cached_measures"] = data.cachedMeasures;
+    stats["measure_cache_evictions"] = data.measureCacheEvictions;
+    stats["measure_callbacks"] = data.measureCallbacks;
+    stats["measure_callback_reasons"] = reasons;
+    return stats;
 }
 
 double Flexbox::get_computed_left(void) const
@@ -517,6 +1840,46 @@ double Flexbox::get_computed_padding(int edge) const
 {
     return YGNodeLayoutGetPadding(m_node, static_cast<YGEdge>(edge));
 }
+
+PackedFloat32Array Flexbox::get_children_layouts_packed(void) const
+{
+    const uint32_t childCount = YGNodeGetChildCount(m_node);
+    PackedFloat32Array layouts;
+    layouts.resize(childCount * 4);
+    float *out = layouts.ptrw();
+    for (uint32_t i = 0; i < childCount; i++)
+    {
+        out = writeLayout(YGNodeGetChild(m_node, i), out);
+    }
+    return layouts;
+}
+
+PackedFloat32Array Flexbox::get_descendants_layouts_packed(void) const
+{
+    const uint32_t count = countDescendants(m_node);
+    std::vector<float> columns(count * 4);
+    YGLayoutBuffer buffer = {};
+    setLayoutArrays(buffer, columns.data(), count);
+    buffer.capacity = count;
+    const uint32_t childCount = YGNodeGetChildCount(m_node);
+    for (uint32_t i = 0; i < childCount; i++)
+    {
+        YGNodeAppendLayoutToBuffer(YGNodeGetChild(m_node, i), &buffer);
+    }
+
+    // Scripts read one rect per node.
+    PackedFloat32Array layouts;
+    layouts.resize(count * 4);
+    float *out = layouts.ptrw();
+    for (uint32_t i = 0; i < count; i++)
+    {
+        out[i * 4] = buffer.left[i];
+        out[i * 4 + 1] = buffer.top[i];
+        out[i * 4 + 2] = buffer.width[i];
+        out[i * 4 + 3] = buffer.height[i];
+    }
+    return layouts;
+}
 //====================================================
 
 void Flexbox::set_is_reference_baseline(bool isReferenceBaseline)
@@ -531,15 +1894,182 @@ bool Flexbox::is_reference_baseline()
 void Flexbox::set_measure_func(const Callable &funcRef)
 {
     m_measureFunc = std::make_unique<Callable>(funcRef);
+    m_measureKind = MEASURE_CALLABLE_DICTIONARY;
+    m_measureControl = 0;
+
+    YGNodeSetMeasureFunc(m_node, &globalMeasureFunc);
+    _measure_source_changed();
+}
+
+void Flexbox::set_measure_func_vector2(const Callable &funcRef)
+{
+    set_measure_func(funcRef);
+    m_measureKind = MEASURE_CALLABLE_VECTOR2;
+}
+
+void Flexbox::set_measure_control(Control *control)
+{
+    ERR_FAIL_NULL(control);
+    m_measureFunc = nullptr;
+    m_measureKind = MEASURE_CONTROL;
+    m_measureControl = control->get_instance_id();
 
     YGNodeSetMeasureFunc(m_node, &globalMeasureFunc);
+    _measure_source_changed();
 }
 
 void Flexbox::unset_measure_func(void)
 {
     m_measureFunc = nullptr;
+    m_measureKind = MEASURE_NONE;
+    m_measureControl = 0;
 
     YGNodeSetMeasureFunc(m_node, nullptr);
+    _measure_source_changed();
+}
+
+// Sizes memoized or laid out with the previous measure source are stale.
+void Flexbox::_measure_source_changed(void)
+{
+    clear_measure_cache();
+    m_node->markContentDirtyAndPropogate();
+}
+
+int Flexbox::get_measure_kind(void) const
+{
+    return m_measureKind;
+}
+
+void Flexbox::set_measure_cache_size(int size)
+{
+    ERR_FAIL_COND(size < 0);
+    m_measureCacheSize = size;
+    clear_measure_cache();
+    m_measureCache.reserve(size);
+}
+
+int Flexbox::get_measure_cache_size(void) const
+{
+    return m_measureCacheSize;
+}
+
+void Flexbox::set_content_version(int64_t version)
+{
+    if (version == m_contentVersion)
+    {
+        return;
+    }
+    m_contentVersion = version;
+    clear_measure_cache();
+    if (YGNodeHasMeasureFunc(m_node))
+    {
+        YGNodeMarkDirty(m_node);
+    }
+}
+
+int64_t Flexbox::get_content_version(void) const
+{
+    return m_contentVersion;
+}
+
+void Flexbox::clear_measure_cache(void)
+{
+    m_measureCache.clear();
+    m_measureCacheNext = 0;
+}
+
+int64_t Flexbox::get_measure_cache_hits(void) const
+{
+    return m_measureCacheHits;
+}
+
+int64_t Flexbox::get_measure_cache_misses(void) const
+{
+    return m_measureCacheMisses;
+}
+
+// Exact match, undefined (NaN) constraints compare equal to each other.
+static bool sameConstraint(float a, float b)
+{
+    return a == b || (YGFloatIsUndefined(a) && YGFloatIsUndefined(b));
+}
+
+YGSize Flexbox::measure(
+    float width,
+    YGMeasureMode widthMode,
+    float height,
+    YGMeasureMode heightMode)
+{
+    if (m_measureCacheSize == 0)
+    {
+        return measure_uncached(width, widthMode, height, heightMode);
+    }
+    for (const MeasureCacheEntry &entry : m_measureCache)
+    {
+        if (entry.widthMode == widthMode && entry.heightMode == heightMode &&
+            sameConstraint(entry.width, width) && sameConstraint(entry.height, height))
+        {
+            m_measureCacheHits++;
+            return entry.size;
+        }
+    }
+    m_measureCacheMisses++;
+
+    const YGSize size = measure_uncached(width, widthMode, height, heightMode);
+    const MeasureCacheEntry entry = {width, height, widthMode, heightMode, size};
+    if (m_measureCache.size() < m_measureCacheSize)
+    {
+        m_measureCache.push_back(entry);
+    }
+    else
+    {
+        m_measureCache[m_measureCacheNext] = entry;
+        m_measureCacheNext = (m_measureCacheNext + 1) % m_measureCacheSize;
+    }
+    return size;
+}
+
+YGSize Flexbox::measure_uncached(
+    float width,
+    YGMeasureMode widthMode,
+    float height,
+    YGMeasureMode heightMode)
+{
+    switch (m_measureKind)
+    {
+    case MEASURE_CONTROL:
+    {
+        // Queried directly, no Variant boxing on the way in or out.
+        Control *control = Object::cast_to<Control>(ObjectDB::get_instance(m_measureControl));
+        if (control == nullptr)
+        {
+            return {0, 0};
+        }
+        const Vector2 size = control->get_combined_minimum_size();
+        return {
+            constrainMeasuredSize(size.x, width, widthMode),
+            constrainMeasuredSize(size.y, height, heightMode)};
+    }
+    case MEASURE_CALLABLE_VECTOR2:
+    {
+        if (!m_measureFunc->is_valid())
+        {
+            return {0, 0};
+        }
+        const Vector2 size = m_measureFunc->call(width, static_cast<int>(widthMode), height, static_cast<int>(heightMode));
+        return {size.x, size.y};
+    }
+    case MEASURE_CALLABLE_DICTIONARY:
+    {
+        const Dictionary &size = call_measure_func(width, widthMode, height, heightMode);
+        Variant w = size["width"];
+        Variant h = size["height"];
+        YGSize ygSize = {static_cast<float>(w), static_cast<float>(h)};
+        return ygSize;
+    }
+    default:
+        return {0, 0};
+    }
 }
 
 Dictionary Flexbox::call_measure_func(
@@ -577,14 +2107,38 @@ void Flexbox::set_dirtied_func(const Callable &funcRef)
 {
     m_dirtiedFunc = std::make_unique<Callable>(funcRef);
 
-    YGNodeSetDirtiedFunc(m_node, &globalDirtiedFunc);
+    if (!m_dirtiedQueued)
+    {
+        YGNodeSetDirtiedFunc(m_node, &globalDirtiedFunc);
+    }
 }
 
 void Flexbox::unset_dirtied_func(void)
 {
     m_dirtiedFunc = nullptr;
 
-    YGNodeSetDirtiedFunc(m_node, nullptr);
+    if (!m_dirtiedQueued)
+    {
+        YGNodeSetDirtiedFunc(m_node, nullptr);
+    }
+}
+
+void Flexbox::set_dirtied_queued(bool queued)
+{
+    m_dirtiedQueued = queued;
+    if (queued)
+    {
+        YGNodeSetDirtiedFunc(m_node, &queuedDirtiedFunc);
+    }
+    else
+    {
+        YGNodeSetDirtiedFunc(m_node, m_dirtiedFunc != nullptr ? &globalDirtiedFunc : nullptr);
+    }
+}
+
+bool Flexbox::get_dirtied_queued(void) const
+{
+    return m_dirtiedQueued;
 }
 
 void Flexbox::mark_dirty(void)
@@ -599,8 +2153,46 @@ bool Flexbox::is_dirty(void) const
 
 void Flexbox::_bind_methods()
 {
+    BIND_CONSTANT(STYLE_POSITION_TYPE);
+    BIND_CONSTANT(STYLE_POSITION);
+    BIND_CONSTANT(STYLE_ALIGN_CONTENT);
+    BIND_CONSTANT(STYLE_ALIGN_ITEMS);
+    BIND_CONSTANT(STYLE_ALIGN_SELF);
+    BIND_CONSTANT(STYLE_FLEX_DIRECTION);
+    BIND_CONSTANT(STYLE_FLEX_WRAP);
+    BIND_CONSTANT(STYLE_JUSTIFY_CONTENT);
+    BIND_CONSTANT(STYLE_MARGIN);
+    BIND_CONSTANT(STYLE_OVERFLOW);
+    BIND_CONSTANT(STYLE_DISPLAY);
+    BIND_CONSTANT(STYLE_FLEX);
+    BIND_CONSTANT(STYLE_FLEX_BASIS);
+    BIND_CONSTANT(STYLE_FLEX_GROW);
+    BIND_CONSTANT(STYLE_FLEX_SHRINK);
+    BIND_CONSTANT(STYLE_WIDTH);
+    BIND_CONSTANT(STYLE_HEIGHT);
+    BIND_CONSTANT(STYLE_MIN_WIDTH);
+    BIND_CONSTANT(STYLE_MIN_HEIGHT);
+    BIND_CONSTANT(STYLE_MAX_WIDTH);
+    BIND_CONSTANT(STYLE_MAX_HEIGHT);
+    BIND_CONSTANT(STYLE_ASPECT_RATIO);
+    BIND_CONSTANT(STYLE_BORDER);
+    BIND_CONSTANT(STYLE_PADDING);
+    BIND_CONSTANT(STYLE_GAP);
+    BIND_CONSTANT(STYLE_RECORD_SIZE);
+    BIND_CONSTANT(STYLE_FIXED_SIZE);
+    BIND_CONSTANT(MEASURE_NONE);
+    BIND_CONSTANT(MEASURE_CALLABLE_DICTIONARY);
+    BIND_CONSTANT(MEASURE_CALLABLE_VECTOR2);
+    BIND_CONSTANT(MEASURE_CONTROL);
+    BIND_CONSTANT(MEASUREMENT_CACHE_FLUSH);
+    BIND_CONSTANT(MEASUREMENT_CACHE_LRU);
+
     ClassDB::bind_static_method("Flexbox", D_METHOD("destroy"), &Flexbox::destroy);
     ClassDB::bind_method(D_METHOD("copy_style"), &Flexbox::copy_style);
+    ClassDB::bind_method(D_METHOD("apply_style"), &Flexbox::apply_style);
+    ClassDB::bind_method(D_METHOD("apply_style_packed"), &Flexbox::apply_style_packed);
+    ClassDB::bind_method(D_METHOD("serialize_tree"), &Flexbox::serialize_tree);
+    ClassDB::bind_method(D_METHOD("deserialize_tree"), &Flexbox::deserialize_tree);
     ClassDB::bind_method(D_METHOD("set_position_type"), &Flexbox::set_position_type);
     ClassDB::bind_method(D_METHOD("set_position"), &Flexbox::set_position);
     ClassDB::bind_method(D_METHOD("set_position_percent"), &Flexbox::set_position_percent);
@@ -674,21 +2266,68 @@ void Flexbox::_bind_methods()
     ClassDB::bind_method(D_METHOD("get_border"), &Flexbox::get_border);
     ClassDB::bind_method(D_METHOD("get_padding"), &Flexbox::get_padding);
     ClassDB::bind_method(D_METHOD("get_gap"), &Flexbox::get_gap);
+    ClassDB::bind_method(D_METHOD("get_position_vector2"), &Flexbox::get_position_vector2);
+    ClassDB::bind_method(D_METHOD("get_margin_vector2"), &Flexbox::get_margin_vector2);
+    ClassDB::bind_method(D_METHOD("get_flex_basis_vector2"), &Flexbox::get_flex_basis_vector2);
+    ClassDB::bind_method(D_METHOD("get_width_vector2"), &Flexbox::get_width_vector2);
+    ClassDB::bind_method(D_METHOD("get_height_vector2"), &Flexbox::get_height_vector2);
+    ClassDB::bind_method(D_METHOD("get_min_width_vector2"), &Flexbox::get_min_width_vector2);
+    ClassDB::bind_method(D_METHOD("get_min_height_vector2"), &Flexbox::get_min_height_vector2);
+    ClassDB::bind_method(D_METHOD("get_max_width_vector2"), &Flexbox::get_max_width_vector2);
+    ClassDB::bind_method(D_METHOD("get_max_height_vector2"), &Flexbox::get_max_height_vector2);
+    ClassDB::bind_method(D_METHOD("get_padding_vector2"), &Flexbox::get_padding_vector2);
+    ClassDB::bind_method(D_METHOD("get_style_packed"), &Flexbox::get_style_packed);
+    ClassDB::bind_method(D_METHOD("get_style_fixed_packed"), &Flexbox::get_style_fixed_packed);
+    ClassDB::bind_static_method("Flexbox", D_METHOD("get_style_fixed_offset"), &Flexbox::get_style_fixed_offset);
     ClassDB::bind_method(D_METHOD("is_reference_baseline"), &Flexbox::is_reference_baseline);
 
     ClassDB::bind_method(D_METHOD("insert_child"), &Flexbox::insert_child);
     ClassDB::bind_method(D_METHOD("remove_child"), &Flexbox::remove_child);
+    ClassDB::bind_method(D_METHOD("set_children"), &Flexbox::set_children);
+    ClassDB::bind_method(D_METHOD("remove_all_children"), &Flexbox::remove_all_children);
     ClassDB::bind_method(D_METHOD("get_child_count"), &Flexbox::get_child_count);
     ClassDB::bind_method(D_METHOD("get_child"), &Flexbox::get_child);
 
     ClassDB::bind_method(D_METHOD("set_measure_func"), &Flexbox::set_measure_func);
+    ClassDB::bind_method(D_METHOD("set_measure_func_vector2"), &Flexbox::set_measure_func_vector2);
+    ClassDB::bind_method(D_METHOD("set_measure_control"), &Flexbox::set_measure_control);
     ClassDB::bind_method(D_METHOD("unset_measure_func"), &Flexbox::unset_measure_func);
+    ClassDB::bind_method(D_METHOD("get_measure_kind"), &Flexbox::get_measure_kind);
+    ClassDB::bind_method(D_METHOD("set_measure_cache_size"), &Flexbox::set_measure_cache_size);
+    ClassDB::bind_method(D_METHOD("get_measure_cache_size"), &Flexbox::get_measure_cache_size);
+    ClassDB::bind_method(D_METHOD("set_content_version"), &Flexbox::set_content_version);
+    ClassDB::bind_method(D_METHOD("get_content_version"), &Flexbox::get_content_version);
+    ClassDB::bind_method(D_METHOD("clear_measure_cache"), &Flexbox::clear_measure_cache);
+    ClassDB::bind_method(D_METHOD("get_measure_cache_hits"), &Flexbox::get_measure_cache_hits);
+    ClassDB::bind_method(D_METHOD("get_measure_cache_misses"), &Flexbox::get_measure_cache_misses);
     ClassDB::bind_method(D_METHOD("set_dirtied_func"), &Flexbox::set_dirtied_func);
     ClassDB::bind_method(D_METHOD("unset_dirtied_func"), &Flexbox::unset_dirtied_func);
+    ClassDB::bind_method(D_METHOD("set_dirtied_queued"), &Flexbox::set_dirtied_queued);
+    ClassDB::bind_method(D_METHOD("get_dirtied_queued"), &Flexbox::get_dirtied_queued);
     ClassDB::bind_method(D_METHOD("mark_dirty"), &Flexbox::mark_dirty);
     ClassDB::bind_method(D_METHOD("is_dirty"), &Flexbox::is_dirty);
 
     ClassDB::bind_method(D_METHOD("calculate_layout"), &Flexbox::calculate_layout);
+    ClassDB::bind_method(D_METHOD("get_last_layout_stats"), &Flexbox::get_last_layout_stats);
+    ClassDB::bind_method(D_METHOD("calculate_layout_packed"), &Flexbox::calculate_layout_packed);
+    ClassDB::bind_method(D_METHOD("get_layout_details_packed"), &Flexbox::get_layout_details_packed);
+    ClassDB::bind_method(D_METHOD("has_measure_funcs"), &Flexbox::has_measure_funcs);
+    ClassDB::bind_method(D_METHOD("apply_layout_packed"), &Flexbox::apply_layout_packed);
+    ClassDB::bind_method(D_METHOD("get_tree_hash"), &Flexbox::get_tree_hash);
+    ClassDB::bind_method(D_METHOD("calculate_layout_async"), &Flexbox::calculate_layout_async);
+    ClassDB::bind_method(D_METHOD("is_layout_pending"), &Flexbox::is_layout_pending);
+    ClassDB::bind_method(D_METHOD("set_parallel_layout"), &Flexbox::set_parallel_layout);
+    ClassDB::bind_method(D_METHOD("get_parallel_layout"), &Flexbox::get_parallel_layout);
+    ClassDB::bind_method(D_METHOD("set_parallel_layout_threshold"), &Flexbox::set_parallel_layout_threshold);
+    ClassDB::bind_method(D_METHOD("get_parallel_layout_threshold"), &Flexbox::get_parallel_layout_threshold);
+    ClassDB::bind_method(D_METHOD("set_layout_boundary"), &Flexbox::set_layout_boundary);
+    ClassDB::bind_method(D_METHOD("get_layout_boundary"), &Flexbox::get_layout_boundary);
+    ClassDB::bind_method(D_METHOD("needs_layout"), &Flexbox::needs_layout);
+    ClassDB::bind_method(D_METHOD("set_measurement_cache_size"), &Flexbox::set_measurement_cache_size);
+    ClassDB::bind_method(D_METHOD("get_measurement_cache_size"), &Flexbox::get_measurement_cache_size);
+    ClassDB::bind_method(D_METHOD("set_measurement_cache_policy"), &Flexbox::set_measurement_cache_policy);
+    ClassDB::bind_method(D_METHOD("get_measurement_cache_policy"), &Flexbox::get_measurement_cache_policy);
+    ADD_SIGNAL(MethodInfo("layout_ready"));
     ClassDB::bind_method(D_METHOD("get_computed_left"), &Flexbox::get_computed_left);
     ClassDB::bind_method(D_METHOD("get_computed_right"), &Flexbox::get_computed_right);
     ClassDB::bind_method(D_METHOD("get_computed_top"), &Flexbox::get_computed_top);
@@ -700,4 +2339,6 @@ void Flexbox::_bind_methods()
     ClassDB::bind_method(D_METHOD("get_computed_margin"), &Flexbox::get_computed_margin);
     ClassDB::bind_method(D_METHOD("get_computed_padding"), &Flexbox::get_computed_padding);
     ClassDB::bind_method(D_METHOD("get_computed_border"), &Flexbox::get_computed_border);
+    ClassDB::bind_method(D_METHOD("get_children_layouts_packed"), &Flexbox::get_children_layouts_packed);
+    ClassDB::bind_method(D_METHOD("get_descendants_layouts_packed"), &Flexbox::get_descendants_layouts_packed);
 }
@@ -2,11 +2,16 @@
 #define FLEXBOX_CLASS_H
 
 #include <godot_cpp/classes/ref_counted.hpp>
+#include <godot_cpp/classes/control.hpp>
 #include <godot_cpp/classes/global_constants.hpp>
 #include <godot_cpp/core/binder_common.hpp>
 
 #include <memory>
+#include <unordered_map>
+#include <vector>
 #include "yoga/Yoga.h"
+#include "yoga/Yoga-internal.h"
+#include "yoga/event/event.h"
 
 using namespace godot;
 
@@ -22,6 +27,9 @@ public:
     static Flexbox *createWithConfig(YGConfigRef *config);
     static void destroy(Flexbox *node);
     static Flexbox *fromYGNode(YGNodeRef nodeRef);
+    // nullptr for Yoga nodes that do not belong to a Flexbox, e.g. FlexTree
+    // nodes.
+    static Flexbox *fromAnyYGNode(YGNodeRef nodeRef);
 
 public:
     Flexbox();
@@ -30,6 +38,46 @@ public:
 public:
     void reset(void);
 
+public:
+    // Property ids of one apply_style_packed() record.
+    enum StyleProperty
+    {
+        STYLE_POSITION_TYPE,
+        STYLE_POSITION,
+        STYLE_ALIGN_CONTENT,
+        STYLE_ALIGN_ITEMS,
+        STYLE_ALIGN_SELF,
+        STYLE_FLEX_DIRECTION,
+        STYLE_FLEX_WRAP,
+        STYLE_JUSTIFY_CONTENT,
+        STYLE_MARGIN,
+        STYLE_OVERFLOW,
+        STYLE_DISPLAY,
+        STYLE_FLEX,
+        STYLE_FLEX_BASIS,
+        STYLE_FLEX_GROW,
+        STYLE_FLEX_SHRINK,
+        STYLE_WIDTH,
+        STYLE_HEIGHT,
+        STYLE_MIN_WIDTH,
+        STYLE_MIN_HEIGHT,
+        STYLE_MAX_WIDTH,
+        STYLE_MAX_HEIGHT,
+        STYLE_ASPECT_RATIO,
+        STYLE_BORDER,
+        STYLE_PADDING,
+        STYLE_GAP,
+        STYLE_PROPERTY_MAX,
+    };
+    // Record: u8 property, u8 edge/gutter, u8 YGUnit, u8 reserved, f32 value.
+    static const int STYLE_RECORD_SIZE = 8;
+    // get_style_fixed_packed(): 20 single fields, position, margin, padding
+    // and border on each of the 9 edges, and the 3 gaps.
+    static const int STYLE_FIXED_SIZE = (20 + 4 * 9 + 3) * STYLE_RECORD_SIZE;
+    // get_layout_details_packed(): direction, overflow, right, bottom, then
+    // margin, border and padding on the left, top, right and bottom edges.
+    static const int LAYOUT_DETAIL_COUNT = 16;
+
 public:
     void copy_style(Flexbox *other);
     void set_position_type(int positionType);
@@ -80,6 +128,17 @@ public:
     void set_padding_percent(int edge, double padding);
     void set_gap(int gutter, double gapLength);
 
+public: // Batch style mutators, the node is dirtied at most once
+    void apply_style(const Dictionary &style);
+    void apply_style_packed(const PackedByteArray &style);
+    // Same on any Yoga node, main thread only.
+    static void applyStyle(YGNodeRef nodeRef, const Dictionary &style);
+    static void applyStylePacked(YGNodeRef nodeRef, const PackedByteArray &style);
+    // Packed records straight onto the node, dirtying it once per record.
+    static void applyStyleRecords(YGNodeRef nodeRef, const uint8_t *record, const uint8_t *end);
+    // One property, value as in an apply_style() dictionary.
+    static void setStyle(YGNodeRef nodeRef, int property, const Variant &value);
+
 public: // Style getters
     int get_position_type(void) const;
     Variant get_position(int edge) const;
@@ -112,15 +171,52 @@ public: // Style getters
     Variant get_padding(int edge) const;
     float get_gap(int gutter);
 
+public: // Typed style getters, Vector2(value, unit) without a Dictionary
+    Vector2 get_position_vector2(int edge) const;
+    Vector2 get_margin_vector2(int edge) const;
+    Vector2 get_flex_basis_vector2(void) const;
+    Vector2 get_width_vector2(void) const;
+    Vector2 get_height_vector2(void) const;
+    Vector2 get_min_width_vector2(void) const;
+    Vector2 get_min_height_vector2(void) const;
+    Vector2 get_max_width_vector2(void) const;
+    Vector2 get_max_height_vector2(void) const;
+    Vector2 get_padding_vector2(int edge) const;
+    // Records of every field that differs from the default style, in the
+    // apply_style_packed() format. Applied to a fresh node they give back
+    // this style.
+    PackedByteArray get_style_packed(void) const;
+    // Records of every field, STYLE_FIXED_SIZE bytes whatever the style, each
+    // field at the offset get_style_fixed_offset() gives. Also accepted by
+    // apply_style_packed().
+    PackedByteArray get_style_fixed_packed(void) const;
+    // Byte offset of the record of property on edge (or gutter, 0 for the
+    // others) in get_style_fixed_packed(), -1 if there is none.
+    static int get_style_fixed_offset(int property, int edge);
+
 public: // Tree hierarchy mutators
     void insert_child(Flexbox *child, unsigned index);
     void remove_child(Flexbox *child);
+    // Replaces the children in one pass with a single dirty walk, so a
+    // reorder is linear. Takes Flexbox nodes with no parent or this one.
+    void set_children(const Array &children);
+    void remove_all_children(void);
 
 public: // Tree hierarchy inspectors
     unsigned get_child_count(void) const;
     Flexbox *get_parent(void);
     Flexbox *get_child(unsigned index);
 
+public: // Tree snapshots
+    // Styles and structure of the subtree as a versioned blob, plus the
+    // computed rects with withLayouts. Measure and dirtied funcs and the
+    // Yoga caches are not saved.
+    PackedByteArray serialize_tree(bool withLayouts) const;
+    // Replaces the style and children of this node with a serialize_tree()
+    // blob in one pass. The new children are kept alive by the Flexbox they
+    // are a child of, until a script removes them.
+    void deserialize_tree(const PackedByteArray &data);
+
 public: // Layout inspectors
     double get_computed_left(void) const;
     double get_computed_right(void) const;
@@ -137,12 +233,41 @@ public: // Layout inspectors
     double get_computed_border(int edge) const;
     double get_computed_padding(int edge) const;
 
+    // [left, top, width, height] per child, relative to its parent.
+    PackedFloat32Array get_children_layouts_packed(void) const;
+    // Same layout, for every descendant in pre-order.
+    PackedFloat32Array get_descendants_layouts_packed(void) const;
+
+public:
+    enum MeasureKind
+    {
+        MEASURE_NONE,
+        MEASURE_CALLABLE_DICTIONARY, // func(w, wm, h, hm) -> {width, height}
+        MEASURE_CALLABLE_VECTOR2,    // func(w, wm, h, hm) -> Vector2
+        MEASURE_CONTROL,             // Control.get_combined_minimum_size()
+    };
+
 public: // Measure func mutators
     void set_measure_func(const Callable &funcRef);
+    void set_measure_func_vector2(const Callable &funcRef);
+    void set_measure_control(Control *control);
     void unset_measure_func(void);
 
+public: // Measure result memoization, opt-in
+    // Results are kept across Yoga invalidations until the content version
+    // changes, bump it whenever the measured content itself changes.
+    void set_measure_cache_size(int size);
+    int get_measure_cache_size(void) const;
+    void set_content_version(int64_t version);
+    int64_t get_content_version(void) const;
+    void clear_measure_cache(void);
+    int64_t get_measure_cache_hits(void) const;
+    int64_t get_measure_cache_misses(void) const;
+
 public: // Measure func inspectors
-    // YGSize measure(YGNodeRef nodeRef, float width, int widthMode, float height, int heightMode);
+    int get_measure_kind(void) const;
+    YGSize measure(float width, YGMeasureMode widthMode, float height, YGMeasureMode heightMode);
+    YGSize measure_uncached(float width, YGMeasureMode widthMode, float height, YGMeasureMode heightMode);
     Dictionary call_measure_func(
         double width,
         int widthMode,
@@ -152,6 +277,10 @@ public: // Measure func inspectors
 public: // Dirtied func mutators
     void set_dirtied_func(const Callable &funcRef);
     void unset_dirtied_func(void);
+    // Sends dirtied notifications of this node through FlexDirtiedQueue
+    // instead of calling its dirtied func.
+    void set_dirtied_queued(bool queued);
+    bool get_dirtied_queued(void) const;
 
 public: // Dirtied func inspectors
     void call_dirtied_func(void);
@@ -163,12 +292,127 @@ public: // Dirtiness accessors
 public: // Layout mutators
     void calculate_layout(double width, double height, int direction);
     // void calculate_layout(void);
+    // Counters of the last calculate_layout() on this node.
+    Dictionary get_last_layout_stats(void) const;
+    // Lays out the tree, then returns every rect of it in one pass as
+    // [left * n, top * n, width * n, height * n], pre-order with this node
+    // first.
+    PackedFloat32Array calculate_layout_packed(double width, double height, int direction);
+    // The other layout values of the tree in the same order, one block of n
+    // floats per value listed by LAYOUT_DETAIL_COUNT.
+    PackedFloat32Array get_layout_details_packed(void) const;
+    // Puts back a calculate_layout_packed() result on a tree of the same
+    // shape without laying it out, returns false if the node count differs.
+    // With empty details the nodes get an inherited direction and no margin,
+    // border or padding until their next layout.
+    bool apply_layout_packed(const PackedFloat32Array &layouts, const PackedFloat32Array &details);
+    // Hash of the styles and structure of the subtree, see serialize_tree().
+    int64_t get_tree_hash(void) const;
+    // Whether this node or one below it has a measure func.
+    bool has_measure_funcs(void) const;
+    // Lays out a snapshot of the tree on the WorkerThreadPool and copies the
+    // result back on the main thread before emitting layout_ready. Measure
+    // funcs may call into scripts or Controls, so trees that have any are
+    // laid out synchronously and layout_ready is still emitted deferred.
+    void calculate_layout_async(double width, double height, int direction);
+    bool is_layout_pending(void) const;
+    // Lays out independent sibling subtrees on several cores when this node
+    // is the root. Subtrees with a measure or baseline func are laid out on
+    // the calling thread, so those funcs may still touch the scene tree.
+    void set_parallel_layout(bool enabled);
+    bool get_parallel_layout(void) const;
+    void set_parallel_layout_threshold(int nodeCount);
+    int get_parallel_layout_threshold(void) const;
+    // Lets this node stop dirtiness coming from its children or measured
+    // content when its width and height are fixed in points. The root then
+    // lays out only this subtree again, check needs_layout() on the root
+    // instead of is_dirty().
+    void set_layout_boundary(bool enabled);
+    bool get_layout_boundary(void) const;
+    bool needs_layout(void) const;
+
+public:
+    enum MeasurementCachePolicy
+    {
+        MEASUREMENT_CACHE_FLUSH = YGMeasurementCachePolicyFlush,
+        MEASUREMENT_CACHE_LRU = YGMeasurementCachePolicyLRU,
+    };
+
+public: // Yoga measurement cache
+    // Entries every node of the tree keeps per layout pass when this node is
+    // the root being laid out, settings of other nodes are ignored. Unlike
+    // set_measure_cache_size(), which memoizes measure func results.
+    // Hits, misses and evictions are in get_last_layout_stats().
+    void set_measurement_cache_size(int size);
+    int get_measurement_cache_size(void) const;
+    void set_measurement_cache_policy(int policy);
+    int get_measurement_cache_policy(void) const;
 public:
     void set_is_reference_baseline(bool isReferenceBaseline);
     bool is_reference_baseline();
     YGNodeRef m_node;
     std::unique_ptr<Callable> m_measureFunc;
+    MeasureKind m_measureKind = MEASURE_NONE;
+    uint64_t m_measureControl = 0;
+
+    struct MeasureCacheEntry
+    {
+        float width;
+        float height;
+        YGMeasureMode widthMode;
+        YGMeasureMode heightMode;
+        YGSize size;
+    };
+    std::vector<MeasureCacheEntry> m_measureCache;
+    uint32_t m_measureCacheSize = 0;
+    uint32_t m_measureCacheNext = 0;
+    int64_t m_contentVersion = 0;
+    int64_t m_measureCacheHits = 0;
+    int64_t m_measureCacheMisses = 0;
     std::unique_ptr<Callable> m_dirtiedFunc;
+    bool m_dirtiedQueued = false;
+    // Already in the FlexDirtiedQueue, cleared when it is drained.
+    bool m_dirtiedPending = false;
+    // Children created by deserialize_tree() while attached to this node,
+    // no script holds them.
+    std::vector<Ref<Flexbox>> m_treeChildren;
+    // The Flexbox holding this node in its m_treeChildren.
+    Flexbox *m_treeHolder = nullptr;
+    facebook::yoga::LayoutData m_lastLayoutData = {};
+    // Tree size seen by the last calculate_layout_packed(), used to size the
+    // next buffer up front.
+    uint32_t m_packedNodeCount = 0;
+    // Own config, created on first use so other roots keep the default one.
+    YGConfigRef m_config = nullptr;
+    YGConfigRef _get_own_config(void);
+    void _measure_source_changed(void);
+    void _hold_tree_child(Flexbox *child);
+    void _release_tree_child(Flexbox *child);
+    void _release_tree_children(void);
+
+    // Back buffer of calculate_layout_async(), owned by the worker task
+    // until _finish_async_layout() swaps it in.
+    struct AsyncLayout
+    {
+        YGNodeRef snapshot = nullptr;
+        // Snapshot node -> node it was cloned from.
+        std::unordered_map<YGNodeRef, YGNodeRef> sources;
+        int64_t task = -1;
+        float width = 0;
+        float height = 0;
+        YGDirection direction = YGDirectionInherit;
+        facebook::yoga::LayoutData layoutData = {};
+        // Latest request made while the task was running.
+        bool requeued = false;
+        float nextWidth = 0;
+        float nextHeight = 0;
+        YGDirection nextDirection = YGDirectionInherit;
+    };
+    AsyncLayout m_async;
+    void _start_async_layout(float width, float height, YGDirection direction);
+    static void _run_async_layout(void *userdata);
+    // Not bound, queued from the worker through callable_mp().
+    void _finish_async_layout(void);
 };
 
 #endif
@@ -8,6 +8,11 @@
 #include <godot_cpp/godot.hpp>
 
 #include "flexbox.h"
+#include "flex_container.h"
+#include "flex_dirtied_queue.h"
+#include "flex_layout_cache.h"
+#include "flex_tree.h"
+#include "flex_profiler.h"
 
 using namespace godot;
 
@@ -19,6 +24,14 @@ void initialize_flexbox_module(ModuleInitializationLevel p_level)
 	}
 
 	ClassDB::register_class<Flexbox>();
+	ClassDB::register_class<FlexContainer>();
+	ClassDB::register_class<FlexDirtiedQueue>();
+	ClassDB::register_class<FlexLayoutCache>();
+	ClassDB::register_class<FlexTree>();
+	ClassDB::register_class<FlexProfiler>();
+
+	FlexDirtiedQueue::initialize();
+	FlexProfiler::initialize();
 }
 
 void uninitialize_flexbox_module(ModuleInitializationLevel p_level)
@@ -27,6 +40,9 @@ void uninitialize_flexbox_module(ModuleInitializationLevel p_level)
 	{
 		return;
 	}
+
+	FlexProfiler::uninitialize();
+	FlexDirtiedQueue::uninitialize();
 }
 
 extern "C"
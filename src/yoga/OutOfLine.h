@@ -0,0 +1,47 @@
+#pragma once
+
+#ifdef __cplusplus
+
+#include <memory>
+
+namespace facebook {
+namespace yoga {
+namespace detail {
+
+// Holds a T that most owners never need, out of line behind one pointer.
+// Null until first written; copies are deep so owners keep value semantics.
+template <typename T>
+class OutOfLine {
+public:
+  OutOfLine() = default;
+  OutOfLine(const OutOfLine& other)
+      : value_{other.value_ ? new T(*other.value_) : nullptr} {}
+  OutOfLine(OutOfLine&&) noexcept = default;
+
+  OutOfLine& operator=(const OutOfLine& other) {
+    if (this != &other) {
+      value_.reset(other.value_ ? new T(*other.value_) : nullptr);
+    }
+    return *this;
+  }
+  OutOfLine& operator=(OutOfLine&&) noexcept = default;
+
+  const T* get() const { return value_.get(); }
+  T* get() { return value_.get(); }
+
+  T& getOrCreate() {
+    if (!value_) {
+      value_.reset(new T());
+    }
+    return *value_;
+  }
+
+private:
+  std::unique_ptr<T> value_;
+};
+
+} // namespace detail
+} // namespace yoga
+} // namespace facebook
+
+#endif
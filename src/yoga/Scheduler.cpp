@@ -0,0 +1,126 @@
+#include "Scheduler.h"
+
+#ifdef THREADS_ENABLED
+
+namespace facebook {
+namespace yoga {
+
+static thread_local size_t tQueueIndex = 0;
+
+Scheduler& Scheduler::get() {
+  static Scheduler scheduler;
+  return scheduler;
+}
+
+Scheduler::Scheduler() {
+  const size_t hardware = std::thread::hardware_concurrency();
+  const size_t workers = hardware > 1 ? hardware - 1 : 1;
+  for (size_t i = 0; i <= workers; i++) {
+    queues_.emplace_back(new Queue());
+  }
+  for (size_t i = 1; i <= workers; i++) {
+    threads_.emplace_back([this, i] { workerLoop(i); });
+  }
+}
+
+Scheduler::~Scheduler() {
+  {
+    std::lock_guard<std::mutex> lock(sleepMutex_);
+    stop_.store(true);
+  }
+  wake_.notify_all();
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+}
+
+bool Scheduler::runOne(const size_t self) {
+  Task task;
+  bool found = false;
+  {
+    Queue& own = *queues_[self];
+    std::lock_guard<std::mutex> lock(own.mutex);
+    if (!own.tasks.empty()) {
+      task = own.tasks.back();
+      own.tasks.pop_back();
+      found = true;
+    }
+  }
+  for (size_t i = 1; !found && i < queues_.size(); i++) {
+    Queue& victim = *queues_[(self + i) % queues_.size()];
+    std::lock_guard<std::mutex> lock(victim.mutex);
+    if (!victim.tasks.empty()) {
+      task = victim.tasks.front();
+      victim.tasks.pop_front();
+      found = true;
+    }
+  }
+  if (!found) {
+    return false;
+  }
+  queued_.fetch_sub(1, std::memory_order_relaxed);
+  task.fn(task.context, task.index);
+  if (task.pending->fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    // The last task of a parallelFor, its caller may be asleep. `pending`
+    // lives on that caller's stack and is gone once it wakes up.
+    std::lock_guard<std::mutex> lock(sleepMutex_);
+    wake_.notify_all();
+  }
+  return true;
+}
+
+void Scheduler::workerLoop(const size_t self) {
+  tQueueIndex = self;
+  while (!stop_.load(std::memory_order_relaxed)) {
+    if (runOne(self)) {
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(sleepMutex_);
+    wake_.wait(lock, [this] {
+      return stop_.load(std::memory_order_relaxed) ||
+          queued_.load(std::memory_order_relaxed) > 0;
+    });
+  }
+}
+
+void Scheduler::parallelFor(
+    const size_t count,
+    const TaskFn fn,
+    void* const context) {
+  if (count == 0) {
+    return;
+  }
+  std::atomic<size_t> pending{count};
+  const size_t self = tQueueIndex;
+  {
+    Queue& own = *queues_[self];
+    std::lock_guard<std::mutex> lock(own.mutex);
+    // Pushed in reverse so the owner pops them in index order.
+    for (size_t i = count; i-- > 0;) {
+      own.tasks.push_back({fn, context, i, &pending});
+    }
+  }
+  {
+    std::lock_guard<std::mutex> lock(sleepMutex_);
+    queued_.fetch_add(count, std::memory_order_relaxed);
+  }
+  wake_.notify_all();
+
+  // Runs queued work, ours or stolen, while there is some. Otherwise sleeps
+  // until a task is queued or the last of ours finishes elsewhere.
+  while (pending.load(std::memory_order_acquire) != 0) {
+    if (runOne(self)) {
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(sleepMutex_);
+    wake_.wait(lock, [this, &pending] {
+      return pending.load(std::memory_order_acquire) == 0 ||
+          queued_.load(std::memory_order_relaxed) > 0;
+    });
+  }
+}
+
+} // namespace yoga
+} // namespace facebook
+
+#endif
@@ -0,0 +1,64 @@
+#pragma once
+
+#if defined(__cplusplus) && defined(THREADS_ENABLED)
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace facebook {
+namespace yoga {
+
+// Work-stealing pool used by parallel layout. Every worker owns a deque, pops
+// its own work LIFO and steals FIFO from the others. A thread waiting on a
+// parallelFor keeps running queued tasks, so nested calls never deadlock.
+// Only built with THREADS_ENABLED; the workers start on the first get(), i.e.
+// the first batch of a config with parallel layout enabled.
+class Scheduler {
+public:
+  using TaskFn = void (*)(void* context, size_t index);
+
+  static Scheduler& get();
+
+  // Runs fn(context, i) for every i in [0, count). The calling thread takes
+  // part and the call returns once every index has run.
+  void parallelFor(size_t count, TaskFn fn, void* context);
+
+  size_t workerCount() const { return threads_.size(); }
+
+  ~Scheduler();
+
+private:
+  struct Task {
+    TaskFn fn;
+    void* context;
+    size_t index;
+    std::atomic<size_t>* pending;
+  };
+  struct Queue {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  Scheduler();
+  bool runOne(size_t self);
+  void workerLoop(size_t self);
+
+  // queues_[0] takes work from threads outside the pool.
+  std::vector<std::unique_ptr<Queue>> queues_;
+  std::vector<std::thread> threads_;
+  std::atomic<size_t> queued_{0};
+  std::atomic<bool> stop_{false};
+  std::mutex sleepMutex_;
+  std::condition_variable wake_;
+};
+
+} // namespace yoga
+} // namespace facebook
+
+#endif
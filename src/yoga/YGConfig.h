@@ -44,6 +44,13 @@ public:
   bool shouldDiffLayoutWithoutLegacyStretchBehaviour = false;
   bool printTree = false;
   float pointScaleFactor = 1.0f;
+  bool parallelLayout = false;
+  uint32_t parallelLayoutThreshold = 64;
+  bool layoutBoundaries = false;
+  uint32_t measurementCacheSize = YG_DEFAULT_CACHED_RESULT_COUNT;
+  YGMeasurementCachePolicy measurementCachePolicy =
+      YGMeasurementCachePolicyFlush;
+  YGNodeArena* nodeArena = nullptr;
   std::array<bool, facebook::yoga::enums::count<YGExperimentalFeature>()>
       experimentalFeatures = {};
   void* context = nullptr;
@@ -169,6 +169,17 @@ const char* YGMeasureModeToString(const YGMeasureMode value) {
   return "unknown";
 }
 
+const char* YGMeasurementCachePolicyToString(
+    const YGMeasurementCachePolicy value) {
+  switch (value) {
+    case YGMeasurementCachePolicyFlush:
+      return "flush";
+    case YGMeasurementCachePolicyLRU:
+      return "lru";
+  }
+  return "unknown";
+}
+
 const char* YGNodeTypeToString(const YGNodeType value) {
   switch (value) {
     case YGNodeTypeDefault:
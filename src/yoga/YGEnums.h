@@ -95,6 +95,11 @@ YG_ENUM_SEQ_DECL(
     YGMeasureModeExactly,
     YGMeasureModeAtMost)
 
+YG_ENUM_SEQ_DECL(
+    YGMeasurementCachePolicy,
+    YGMeasurementCachePolicyFlush,
+    YGMeasurementCachePolicyLRU)
+
 YG_ENUM_SEQ_DECL(
     YGNodeType,
     YGNodeTypeDefault,
@@ -10,7 +10,7 @@
 
 using namespace facebook;
 
-bool YGLayout::operator==(YGLayout layout) const {
+bool YGLayout::operator==(const YGLayout& layout) const {
   bool isEqual = YGFloatArrayEqual(position, layout.position) &&
       YGFloatArrayEqual(dimensions, layout.dimensions) &&
       YGFloatArrayEqual(margin, layout.margin) &&
@@ -24,7 +24,8 @@ bool YGLayout::operator==(YGLayout layout) const {
       computedFlexBasis == layout.computedFlexBasis;
 
   for (uint32_t i = 0; i < YG_MAX_CACHED_RESULT_COUNT && isEqual; ++i) {
-    isEqual = isEqual && cachedMeasurements[i] == layout.cachedMeasurements[i];
+    isEqual =
+        isEqual && cachedMeasurement(i) == layout.cachedMeasurement(i);
   }
 
   if (!yoga::isUndefined(measuredDimensions[0]) ||
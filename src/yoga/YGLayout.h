@@ -10,6 +10,7 @@
 #ifdef __cplusplus
 
 #include "BitUtils.h"
+#include "OutOfLine.h"
 #include "YGFloatOptional.h"
 #include "Yoga-internal.h"
 
@@ -30,6 +31,14 @@ private:
       doesLegacyStretchFlagAffectsLayoutOffset + 1;
   uint8_t flags = 0;
 
+  // Nodes rarely need more than a couple of measurements per pass, the rest
+  // of the cache grows on first use up to the configured size.
+  static constexpr uint32_t kInlineCachedMeasurements = 2;
+  std::array<YGCachedMeasurement, kInlineCachedMeasurements>
+      cachedMeasurements_ = {};
+  facebook::yoga::detail::OutOfLine<std::vector<YGCachedMeasurement>>
+      overflowCachedMeasurements_;
+
 public:
   uint32_t computedFlexBasisGeneration = 0;
   YGFloatOptional computedFlexBasis = {};
@@ -40,12 +49,61 @@ public:
   YGDirection lastOwnerDirection = YGDirectionInherit;
 
   uint32_t nextCachedMeasurementsIndex = 0;
-  std::array<YGCachedMeasurement, YG_MAX_CACHED_RESULT_COUNT>
-      cachedMeasurements = {};
+
+  // What the last pixel grid rounding that reached the node rounded: the
+  // unrounded absolute origin of its owner and the unrounded rect of the
+  // node. Subtrees a pass does not lay out keep their rounded values, and are
+  // rounded again from here when their owner moved.
+  struct PixelGridSource {
+    double ownerLeft = YGUndefined;
+    double ownerTop = YGUndefined;
+    float left = YGUndefined;
+    float top = YGUndefined;
+    float width = YGUndefined;
+    float height = YGUndefined;
+  };
+  PixelGridSource pixelGridSource = {};
   std::array<float, 2> measuredDimensions = {{YGUndefined, YGUndefined}};
 
   YGCachedMeasurement cachedLayout = YGCachedMeasurement();
 
+  YGCachedMeasurement& cachedMeasurement(uint32_t index) {
+    if (index < kInlineCachedMeasurements) {
+      return cachedMeasurements_[index];
+    }
+    auto& overflow = overflowCachedMeasurements_.getOrCreate();
+    index -= kInlineCachedMeasurements;
+    if (index >= overflow.size()) {
+      overflow.resize(index + 1);
+    }
+    return overflow[index];
+  }
+
+  // Entries never written read as empty.
+  const YGCachedMeasurement& cachedMeasurement(uint32_t index) const {
+    static const YGCachedMeasurement empty = {};
+    if (index < kInlineCachedMeasurements) {
+      return cachedMeasurements_[index];
+    }
+    const auto* overflow = overflowCachedMeasurements_.get();
+    index -= kInlineCachedMeasurements;
+    return overflow != nullptr && index < overflow->size() ? (*overflow)[index]
+                                                           : empty;
+  }
+
+  bool ownsOutOfLineStorage() const {
+    return overflowCachedMeasurements_.get() != nullptr;
+  }
+
+  // Moves an entry to the front, the ones before it shift back by one.
+  void promoteCachedMeasurement(uint32_t index) {
+    // Grow the overflow first, the swaps below must not reallocate it.
+    cachedMeasurement(index);
+    for (; index > 0; index--) {
+      std::swap(cachedMeasurement(index), cachedMeasurement(index - 1));
+    }
+  }
+
   YGDirection direction() const {
     return facebook::yoga::detail::getEnumData<YGDirection>(
         flags, directionOffset);
@@ -83,8 +141,8 @@ public:
         flags, hadOverflowOffset, hadOverflow);
   }
 
-  bool operator==(YGLayout layout) const;
-  bool operator!=(YGLayout layout) const { return !(*this == layout); }
+  bool operator==(const YGLayout& layout) const;
+  bool operator!=(const YGLayout& layout) const { return !(*this == layout); }
 };
 
 #endif
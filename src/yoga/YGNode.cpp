@@ -18,8 +18,7 @@ YGNode::YGNode(YGNode&& node) {
   context_ = node.context_;
   flags = node.flags;
   measure_ = node.measure_;
-  baseline_ = node.baseline_;
-  print_ = node.print_;
+  rareFuncs_ = std::move(node.rareFuncs_);
   dirtied_ = node.dirtied_;
   style_ = node.style_;
   layout_ = node.layout_;
@@ -41,11 +40,12 @@ YGNode::YGNode(const YGNode& node, YGConfigRef config) : YGNode{node} {
 }
 
 void YGNode::print(void* printContext) {
-  if (print_.noContext != nullptr) {
+  const RareFuncs* rare = rareFuncs_.get();
+  if (rare != nullptr && rare->print.noContext != nullptr) {
     if (facebook::yoga::detail::getBooleanData(flags, printUsesContext_)) {
-      print_.withContext(this, printContext);
+      rare->print.withContext(this, printContext);
     } else {
-      print_.noContext(this);
+      rare->print.noContext(this);
     }
   }
 }
@@ -210,8 +210,9 @@ YGSize YGNode::measure(
 
 float YGNode::baseline(float width, float height, void* layoutContext) {
   return facebook::yoga::detail::getBooleanData(flags, baselineUsesContext_)
-      ? baseline_.withContext(this, width, height, layoutContext)
-      : baseline_.noContext(this, width, height);
+      ? rareFuncs_.get()->baseline.withContext(
+            this, width, height, layoutContext)
+      : rareFuncs_.get()->baseline.noContext(this, width, height);
 }
 
 // Setters
@@ -272,8 +273,7 @@ void YGNode::setDirty(bool isDirty) {
 }
 
 bool YGNode::removeChild(YGNodeRef child) {
-  std::vector<YGNodeRef>::iterator p =
-      std::find(children_.begin(), children_.end(), child);
+  auto p = std::find(children_.begin(), children_.end(), child);
   if (p != children_.end()) {
     children_.erase(p);
     return true;
@@ -449,13 +449,107 @@ void YGNode::cloneChildrenIfNeeded(void* cloneContext) {
 }
 
 void YGNode::markDirtyAndPropogate() {
-  if (!facebook::yoga::detail::getBooleanData(flags, isDirty_)) {
+  // A boundary may already be dirty from its content while its owner is not.
+  const bool wasDirty = isDirty();
+  if (!wasDirty) {
     setDirty(true);
     setLayoutComputedFlexBasis(YGFloatOptional());
-    if (owner_) {
-      owner_->markDirtyAndPropogate();
+  }
+  if (owner_ && (!wasDirty || !owner_->isDirty())) {
+    owner_->markContentDirtyAndPropogate();
+  }
+}
+
+void YGNode::markContentDirtyAndPropogate() {
+  if (isDirty()) {
+    return;
+  }
+  setDirty(true);
+  setLayoutComputedFlexBasis(YGFloatOptional());
+  if (owner_) {
+    if (isLayoutBoundary()) {
+      owner_->markHasDirtyBoundaryAndPropogate();
+    } else {
+      owner_->markContentDirtyAndPropogate();
+    }
+  }
+}
+
+void YGNode::markHasDirtyBoundaryAndPropogate() {
+  for (YGNodeRef node = this; node != nullptr && !node->hasDirtyBoundary_;
+       node = node->owner_) {
+    node->hasDirtyBoundary_ = true;
+  }
+}
+
+template <typename Values>
+static bool YGHasPercentValue(const Values& values, size_t count) {
+  for (size_t i = 0; i < count; i++) {
+    if (YGValue(values[i]).unit == YGUnitPercent) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Whether YGBaseline of `owner` may read the layout of `child`: the first
+// in-flow child, or the reference one.
+static bool YGMayBeBaselineChild(const YGNode* owner, const YGNode* child) {
+  if (child->isReferenceBaseline()) {
+    return true;
+  }
+  for (const auto sibling : owner->getChildren()) {
+    if (sibling == child) {
+      return true;
+    }
+    if (sibling->getStyle().positionType() != YGPositionTypeAbsolute) {
+      return false;
+    }
+  }
+  return false;
+}
+
+bool YGNode::isLayoutBoundary() const {
+  if (owner_ == nullptr || !config_->layoutBoundaries ||
+      style_.display() == YGDisplayNone) {
+    return false;
+  }
+  const YGValue width = style_.dimensions()[YGDimensionWidth];
+  const YGValue height = style_.dimensions()[YGDimensionHeight];
+  if (width.unit != YGUnitPoint || height.unit != YGUnitPoint) {
+    return false;
+  }
+  // Re-entering at the boundary does not know the size of its owner.
+  constexpr auto edgeCount = yoga::enums::count<YGEdge>();
+  constexpr auto dimensionCount = yoga::enums::count<YGDimension>();
+  if (YGHasPercentValue(style_.margin(), edgeCount) ||
+      YGHasPercentValue(style_.padding(), edgeCount) ||
+      YGHasPercentValue(style_.minDimensions(), dimensionCount) ||
+      YGHasPercentValue(style_.maxDimensions(), dimensionCount)) {
+    return false;
+  }
+
+  // A row aligned by baseline reads the baseline of every child, which comes
+  // from the first child down. Walk up while this node may feed it.
+  const YGNode* child = this;
+  for (const YGNode* owner = owner_; owner != nullptr;
+       child = owner, owner = owner->owner_) {
+    if (!YGFlexDirectionIsColumn(owner->style_.flexDirection())) {
+      if (owner->style_.alignItems() == YGAlignBaseline) {
+        return false;
+      }
+      for (const auto sibling : owner->children_) {
+        if (sibling->style_.positionType() != YGPositionTypeAbsolute &&
+            sibling->style_.alignSelf() == YGAlignBaseline) {
+          return false;
+        }
+      }
+    }
+    if (owner->hasBaselineFunc() || !YGMayBeBaselineChild(owner, child)) {
+      break;
     }
   }
+  return true;
 }
 
 void YGNode::markDirtyAndPropogateDownwards() {
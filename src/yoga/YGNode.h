@@ -13,6 +13,7 @@
 #include <stdio.h>
 #include "BitUtils.h"
 #include "CompactValue.h"
+#include "OutOfLine.h"
 #include "YGConfig.h"
 #include "YGLayout.h"
 #include "YGStyle.h"
@@ -40,18 +41,24 @@ private:
   void* context_ = nullptr;
   uint8_t flags = 1;
   uint8_t reserved_ = 0;
+  // A dirty layout boundary sits somewhere below this clean node.
+  bool hasDirtyBoundary_ = false;
   union {
     YGMeasureFunc noContext;
     MeasureWithContextFn withContext;
   } measure_ = {nullptr};
-  union {
-    YGBaselineFunc noContext;
-    BaselineWithContextFn withContext;
-  } baseline_ = {nullptr};
-  union {
-    YGPrintFunc noContext;
-    PrintWithContextFn withContext;
-  } print_ = {nullptr};
+  // Baseline and print callbacks are set on few nodes, keep them out of line.
+  struct RareFuncs {
+    union {
+      YGBaselineFunc noContext;
+      BaselineWithContextFn withContext;
+    } baseline = {nullptr};
+    union {
+      YGPrintFunc noContext;
+      PrintWithContextFn withContext;
+    } print = {nullptr};
+  };
+  facebook::yoga::detail::OutOfLine<RareFuncs> rareFuncs_;
   YGDirtiedFunc dirtied_ = nullptr;
   YGStyle style_ = {};
   YGLayout layout_ = {};
@@ -67,7 +74,11 @@ private:
       const float axisSize) const;
 
   void setMeasureFunc(decltype(measure_));
-  void setBaselineFunc(decltype(baseline_));
+
+  RareFuncs& rareFuncs() {
+    noteOutOfLineStorage();
+    return rareFuncs_.getOrCreate();
+  }
 
   void useWebDefaults() {
     facebook::yoga::detail::setBooleanData(flags, useWebDefaults_, true);
@@ -86,7 +97,9 @@ private:
 
 public:
   YGNode() : YGNode{YGConfigGetDefault()} {}
-  explicit YGNode(const YGConfigRef config) : config_{config} {
+  explicit YGNode(const YGConfigRef config)
+      : children_{YGVector::allocator_type{config->nodeArena}},
+        config_{config} {
     if (config->useWebDefaults) {
       useWebDefaults();
     }
@@ -127,7 +140,8 @@ public:
   YGSize measure(float, YGMeasureMode, float, YGMeasureMode, void*);
 
   bool hasBaselineFunc() const noexcept {
-    return baseline_.noContext != nullptr;
+    return rareFuncs_.get() != nullptr &&
+        rareFuncs_.get()->baseline.noContext != nullptr;
   }
 
   float baseline(float width, float height, void* layoutContext);
@@ -146,7 +160,7 @@ public:
 
   uint32_t getLineIndex() const { return lineIndex_; }
 
-  bool isReferenceBaseline() {
+  bool isReferenceBaseline() const {
     return facebook::yoga::detail::getBooleanData(flags, isReferenceBaseline_);
   }
 
@@ -181,10 +195,28 @@ public:
 
   YGConfigRef getConfig() const { return config_; }
 
+  // Arena the node and its children array were allocated from, if any.
+  YGNodeArena* getArena() const { return children_.get_allocator().arena; }
+
+  // To be called before the node first allocates storage outside of its
+  // arena, which resetting the arena then has to release.
+  void noteOutOfLineStorage() const {
+    if (YGNodeArena* arena = getArena()) {
+      arena->noteOutOfLineStorage();
+    }
+  }
+
   bool isDirty() const {
     return facebook::yoga::detail::getBooleanData(flags, isDirty_);
   }
 
+  bool hasDirtyBoundary() const { return hasDirtyBoundary_; }
+
+  // Whether changes below this node can leave the rest of the tree alone: its
+  // config opts in, its size is fixed in points and not resolved against its
+  // owner, and no ancestor baseline depends on its content.
+  bool isLayoutBoundary() const;
+
   std::array<YGValue, 2> getResolvedDimensions() const {
     return resolvedDimensions_;
   }
@@ -252,11 +284,15 @@ public:
   void setContext(void* context) { context_ = context; }
 
   void setPrintFunc(YGPrintFunc printFunc) {
-    print_.noContext = printFunc;
+    if (printFunc != nullptr || rareFuncs_.get() != nullptr) {
+      rareFuncs().print.noContext = printFunc;
+    }
     facebook::yoga::detail::setBooleanData(flags, printUsesContext_, false);
   }
   void setPrintFunc(PrintWithContextFn printFunc) {
-    print_.withContext = printFunc;
+    if (printFunc != nullptr || rareFuncs_.get() != nullptr) {
+      rareFuncs().print.withContext = printFunc;
+    }
     facebook::yoga::detail::setBooleanData(flags, printUsesContext_, true);
   }
   void setPrintFunc(std::nullptr_t) { setPrintFunc(YGPrintFunc{nullptr}); }
@@ -278,11 +314,15 @@ public:
 
   void setBaselineFunc(YGBaselineFunc baseLineFunc) {
     facebook::yoga::detail::setBooleanData(flags, baselineUsesContext_, false);
-    baseline_.noContext = baseLineFunc;
+    if (baseLineFunc != nullptr || rareFuncs_.get() != nullptr) {
+      rareFuncs().baseline.noContext = baseLineFunc;
+    }
   }
   void setBaselineFunc(BaselineWithContextFn baseLineFunc) {
     facebook::yoga::detail::setBooleanData(flags, baselineUsesContext_, true);
-    baseline_.withContext = baseLineFunc;
+    if (baseLineFunc != nullptr || rareFuncs_.get() != nullptr) {
+      rareFuncs().baseline.withContext = baseLineFunc;
+    }
   }
   void setBaselineFunc(std::nullptr_t) {
     return setBaselineFunc(YGBaselineFunc{nullptr});
@@ -292,7 +332,12 @@ public:
 
   void setStyle(const YGStyle& style) { style_ = style; }
 
-  void setLayout(const YGLayout& layout) { layout_ = layout; }
+  void setLayout(const YGLayout& layout) {
+    if (layout.ownsOutOfLineStorage()) {
+      noteOutOfLineStorage();
+    }
+    layout_ = layout;
+  }
 
   void setLineIndex(uint32_t lineIndex) { lineIndex_ = lineIndex; }
 
@@ -303,13 +348,19 @@ public:
 
   void setOwner(YGNodeRef owner) { owner_ = owner; }
 
-  void setChildren(const YGVector& children) { children_ = children; }
+  template <typename Children>
+  void setChildren(const Children& children) {
+    children_.assign(children.begin(), children.end());
+  }
 
   // TODO: rvalue override for setChildren
 
-  YG_DEPRECATED void setConfig(YGConfigRef config) { config_ = config; }
+  void setConfig(YGConfigRef config) { config_ = config; }
 
   void setDirty(bool isDirty);
+  void setHasDirtyBoundary(bool hasDirtyBoundary) {
+    hasDirtyBoundary_ = hasDirtyBoundary;
+  }
   void setLayoutLastOwnerDirection(YGDirection direction);
   void setLayoutComputedFlexBasis(const YGFloatOptional computedFlexBasis);
   void setLayoutComputedFlexBasisGeneration(
@@ -347,7 +398,12 @@ public:
   void removeChild(uint32_t index);
 
   void cloneChildrenIfNeeded(void*);
+  // For changes to this node's own style. Its owner always lays it out again.
   void markDirtyAndPropogate();
+  // For changes to the children or measured content of this node. They stop
+  // at the first layout boundary, whose ancestors are only flagged.
+  void markContentDirtyAndPropogate();
+  void markHasDirtyBoundaryAndPropogate();
   float resolveFlexGrow() const;
   float resolveFlexShrink() const;
   bool isNodeFlexible();
@@ -0,0 +1,116 @@
+#include "YGNodeArena.h"
+
+#include <algorithm>
+#include <new>
+
+#include "YGNode.h"
+
+YGNodeArena::~YGNodeArena() {
+  reset();
+  for (void* slab : slabs_) {
+    ::operator delete(slab);
+  }
+}
+
+void* YGNodeArena::allocate(size_t size) {
+  size = (std::max<size_t>(size, 1) + kGranularity - 1) & ~(kGranularity - 1);
+  liveAllocations_++;
+
+  if (size > kMaxPooledSize) {
+    void* block = ::operator new(size);
+    largeBlocks_.push_back(block);
+    return block;
+  }
+
+  FreeBlock*& freeList = freeLists_[size / kGranularity - 1];
+  if (freeList != nullptr) {
+    FreeBlock* block = freeList;
+    freeList = block->next;
+    return block;
+  }
+
+  if (slabs_.empty()) {
+    slabs_.push_back(::operator new(kSlabSize));
+    currentSlab_ = 0;
+    slabOffset_ = 0;
+  } else if (slabOffset_ + size > kSlabSize) {
+    // The tail of the slab is dropped, slabs left over by reset() come first.
+    currentSlab_++;
+    if (currentSlab_ == slabs_.size()) {
+      slabs_.push_back(::operator new(kSlabSize));
+    }
+    slabOffset_ = 0;
+  }
+  void* block = static_cast<char*>(slabs_[currentSlab_]) + slabOffset_;
+  slabOffset_ += size;
+  return block;
+}
+
+void YGNodeArena::deallocate(void* pointer, size_t size) {
+  if (pointer == nullptr) {
+    return;
+  }
+  size = (std::max<size_t>(size, 1) + kGranularity - 1) & ~(kGranularity - 1);
+  liveAllocations_--;
+
+  if (size > kMaxPooledSize) {
+    auto it = std::find(largeBlocks_.begin(), largeBlocks_.end(), pointer);
+    if (it != largeBlocks_.end()) {
+      *it = largeBlocks_.back();
+      largeBlocks_.pop_back();
+    }
+    ::operator delete(pointer);
+    return;
+  }
+
+  FreeBlock* block = static_cast<FreeBlock*>(pointer);
+  FreeBlock*& freeList = freeLists_[size / kGranularity - 1];
+  block->next = freeList;
+  freeList = block;
+}
+
+void* YGNodeArena::allocateNode() {
+  NodeLink* link =
+      static_cast<NodeLink*>(allocate(sizeof(NodeLink) + sizeof(YGNode)));
+  link->prev = nullptr;
+  link->next = liveNodes_;
+  if (liveNodes_ != nullptr) {
+    liveNodes_->prev = link;
+  }
+  liveNodes_ = link;
+  return link + 1;
+}
+
+void YGNodeArena::deallocateNode(void* node) {
+  NodeLink* link = static_cast<NodeLink*>(node) - 1;
+  if (link->prev != nullptr) {
+    link->prev->next = link->next;
+  } else {
+    liveNodes_ = link->next;
+  }
+  if (link->next != nullptr) {
+    link->next->prev = link->prev;
+  }
+  deallocate(link, sizeof(NodeLink) + sizeof(YGNode));
+}
+
+void YGNodeArena::reset() {
+  // Child arrays go back to the free lists meanwhile, cleared below. Without
+  // out of line storage the nodes hold nothing the slabs do not.
+  if (nodesOwnOutOfLine_.exchange(false, std::memory_order_relaxed)) {
+    for (NodeLink* link = liveNodes_; link != nullptr;) {
+      NodeLink* next = link->next;
+      reinterpret_cast<YGNode*>(link + 1)->~YGNode();
+      link = next;
+    }
+  }
+  liveNodes_ = nullptr;
+  for (void* block : largeBlocks_) {
+    ::operator delete(block);
+  }
+  largeBlocks_.clear();
+  std::fill(std::begin(freeLists_), std::end(freeLists_), nullptr);
+  currentSlab_ = 0;
+  slabOffset_ = 0;
+  liveAllocations_ = 0;
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#ifdef __cplusplus
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+// Slab allocator for YGNodes and their child arrays, used by every node
+// created with a config that has one (YGConfigSetNodeArena). Not thread safe:
+// trees of one arena must be built, edited and freed from one thread at a
+// time. Layout itself does not allocate from it.
+struct YGNodeArena {
+  YGNodeArena() = default;
+  YGNodeArena(const YGNodeArena&) = delete;
+  YGNodeArena& operator=(const YGNodeArena&) = delete;
+  ~YGNodeArena();
+
+  void* allocate(size_t size);
+  void deallocate(void* pointer, size_t size);
+
+  // Storage for one YGNode. Nodes are linked so that reset() can find the
+  // ones still alive.
+  void* allocateNode();
+  void deallocateNode(void* node);
+
+  // Forgets every allocation at once, slabs are kept for reuse. The
+  // destructor of every node still alive only runs if one of them noted
+  // storage outside the arena. Nodes of the arena must not be touched
+  // afterwards.
+  void reset();
+
+  // Called by nodes, possibly from layout threads, before they first
+  // allocate outside the arena.
+  void noteOutOfLineStorage() {
+    nodesOwnOutOfLine_.store(true, std::memory_order_relaxed);
+  }
+
+  size_t liveAllocationCount() const { return liveAllocations_; }
+  size_t slabCount() const { return slabs_.size(); }
+
+private:
+  static constexpr size_t kSlabSize = 64 * 1024;
+  static constexpr size_t kGranularity = 16;
+  static constexpr size_t kMaxPooledSize = 4096;
+
+  struct FreeBlock {
+    FreeBlock* next;
+  };
+  // Precedes every node, a multiple of kGranularity keeps nodes aligned.
+  struct alignas(kGranularity) NodeLink {
+    NodeLink* prev;
+    NodeLink* next;
+  };
+
+  std::vector<void*> slabs_;
+  std::vector<void*> largeBlocks_;
+  size_t currentSlab_ = 0;
+  size_t slabOffset_ = 0;
+  size_t liveAllocations_ = 0;
+  NodeLink* liveNodes_ = nullptr;
+  std::atomic<bool> nodesOwnOutOfLine_{false};
+  FreeBlock* freeLists_[kMaxPooledSize / kGranularity] = {};
+};
+
+namespace facebook {
+namespace yoga {
+
+// Allocator of YGVector. Children of an arena node live in the node's arena,
+// and the arena a node was allocated from is read back from it on free.
+template <typename T>
+struct ArenaAllocator {
+  using value_type = T;
+
+  YGNodeArena* arena = nullptr;
+
+  ArenaAllocator() noexcept = default;
+  explicit ArenaAllocator(YGNodeArena* nodeArena) noexcept
+      : arena{nodeArena} {}
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U>& other) noexcept
+      : arena{other.arena} {}
+
+  T* allocate(size_t count) {
+    const size_t size = count * sizeof(T);
+    return static_cast<T*>(
+        arena != nullptr ? arena->allocate(size) : ::operator new(size));
+  }
+
+  void deallocate(T* pointer, size_t count) noexcept {
+    if (arena != nullptr) {
+      arena->deallocate(pointer, count * sizeof(T));
+    } else {
+      ::operator delete(pointer);
+    }
+  }
+};
+
+template <typename T, typename U>
+bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) {
+  return a.arena == b.arena;
+}
+
+template <typename T, typename U>
+bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) {
+  return a.arena != b.arena;
+}
+
+} // namespace yoga
+} // namespace facebook
+
+#endif
@@ -14,9 +14,11 @@
 #include <cmath>
 #include <vector>
 #include "CompactValue.h"
+#include "YGNodeArena.h"
 #include "Yoga.h"
 
-using YGVector = std::vector<YGNodeRef>;
+using YGVector =
+    std::vector<YGNodeRef, facebook::yoga::ArenaAllocator<YGNodeRef>>;
 
 YG_EXTERN_C_BEGIN
 
@@ -42,6 +44,18 @@ inline bool isUndefined(double value) {
 
 void throwLogicalErrorWithMessage(const char* message);
 
+struct LayoutData;
+
+// Same as YGNodeCalculateLayoutWithContext, additionally copying the pass
+// counters into layoutData (when not null) whether or not events are enabled.
+void calculateLayoutWithData(
+    YGNodeRef node,
+    float availableWidth,
+    float availableHeight,
+    YGDirection ownerDirection,
+    void* layoutContext,
+    LayoutData* layoutData);
+
 } // namespace yoga
 } // namespace facebook
 
@@ -95,9 +109,11 @@ struct YGCachedMeasurement {
   }
 };
 
-// This value was chosen based on empirical data:
-// 98% of analyzed layouts require less than 8 entries.
-#define YG_MAX_CACHED_RESULT_COUNT 8
+// Default of YGConfigSetMeasurementCacheSize. This value was chosen based on
+// empirical data: 98% of analyzed layouts require less than 8 entries.
+#define YG_DEFAULT_CACHED_RESULT_COUNT 8
+// Upper bound of YGConfigSetMeasurementCacheSize.
+#define YG_MAX_CACHED_RESULT_COUNT 32
 
 namespace facebook {
 namespace yoga {
@@ -15,6 +15,7 @@
 #include "Utils.h"
 #include "YGNode.h"
 #include "YGNodePrint.h"
+#include "Scheduler.h"
 #include "Yoga-internal.h"
 #include "event/event.h"
 #ifdef _MSC_VER
@@ -180,6 +181,10 @@ YOGA_EXPORT bool YGNodeIsDirty(YGNodeRef node) {
   return node->isDirty();
 }
 
+YOGA_EXPORT bool YGNodeNeedsLayout(YGNodeRef node) {
+  return node->isDirty() || node->hasDirtyBoundary();
+}
+
 YOGA_EXPORT bool YGNodeLayoutGetDidUseLegacyFlag(const YGNodeRef node) {
   return node->didUseLegacyFlag();
 }
@@ -191,8 +196,27 @@ YOGA_EXPORT void YGNodeMarkDirtyAndPropogateToDescendants(
 
 int32_t gConfigInstanceCount = 0;
 
+// Node storage comes from the arena when there is one, see YGNodeArena.
+template <typename... Args>
+static YGNodeRef YGNodeAllocate(YGNodeArena* arena, Args&&... args) {
+  if (arena == nullptr) {
+    return new YGNode{std::forward<Args>(args)...};
+  }
+  return new (arena->allocateNode()) YGNode{std::forward<Args>(args)...};
+}
+
+static void YGNodeDeallocate(const YGNodeRef node) {
+  YGNodeArena* arena = node->getArena();
+  if (arena == nullptr) {
+    delete node;
+    return;
+  }
+  node->~YGNode();
+  arena->deallocateNode(node);
+}
+
 YOGA_EXPORT WIN_EXPORT YGNodeRef YGNodeNewWithConfig(const YGConfigRef config) {
-  const YGNodeRef node = new YGNode{config};
+  const YGNodeRef node = YGNodeAllocate(config->nodeArena, config);
   YGAssertWithConfig(
       config, node != nullptr, "Could not allocate memory for node");
   Event::publish<Event::NodeAllocation>(node, {config});
@@ -210,7 +234,7 @@ YOGA_EXPORT YGNodeRef YGNodeNew(void) {
 }
 
 YOGA_EXPORT YGNodeRef YGNodeClone(YGNodeRef oldNode) {
-  YGNodeRef node = new YGNode(*oldNode);
+  YGNodeRef node = YGNodeAllocate(oldNode->getArena(), *oldNode);
   YGAssertWithConfig(
       oldNode->getConfig(),
       node != nullptr,
@@ -229,7 +253,7 @@ static YGConfigRef YGConfigClone(const YGConfig& oldConfig) {
 
 static YGNodeRef YGNodeDeepClone(YGNodeRef oldNode) {
   auto config = YGConfigClone(*oldNode->getConfig());
-  auto node = new YGNode{*oldNode, config};
+  auto node = YGNodeAllocate(oldNode->getArena(), *oldNode, config);
   node->setOwner(nullptr);
   Event::publish<Event::NodeAllocation>(node, {node->getConfig()});
 
@@ -260,7 +284,7 @@ YOGA_EXPORT void YGNodeFree(const YGNodeRef node) {
 
   node->clearChildren();
   Event::publish<Event::NodeDeallocation>(node, {node->getConfig()});
-  delete node;
+  YGNodeDeallocate(node);
 }
 
 static void YGConfigFreeRecursive(const YGNodeRef root) {
@@ -354,7 +378,10 @@ YOGA_EXPORT void YGNodeInsertChild(
 
   owner->insertChild(child, index);
   child->setOwner(owner);
-  owner->markDirtyAndPropogate();
+  owner->markContentDirtyAndPropogate();
+  if (child->hasDirtyBoundary()) {
+    owner->markHasDirtyBoundaryAndPropogate();
+  }
 }
 
 YOGA_EXPORT void YGNodeSwapChild(
@@ -382,7 +409,7 @@ YOGA_EXPORT void YGNodeRemoveChild(
       excludedChild->setLayout({}); // layout is no longer valid
       excludedChild->setOwner(nullptr);
     }
-    owner->markDirtyAndPropogate();
+    owner->markContentDirtyAndPropogate();
   }
 }
 
@@ -402,13 +429,13 @@ YOGA_EXPORT void YGNodeRemoveAllChildren(const YGNodeRef owner) {
       oldChild->setOwner(nullptr);
     }
     owner->clearChildren();
-    owner->markDirtyAndPropogate();
+    owner->markContentDirtyAndPropogate();
     return;
   }
   // Otherwise, we are not the owner of the child set. We don't have to do
   // anything to clear it.
   owner->setChildren(YGVector());
-  owner->markDirtyAndPropogate();
+  owner->markContentDirtyAndPropogate();
 }
 
 static void YGNodeSetChildrenInternal(
@@ -424,25 +451,31 @@ static void YGNodeSetChildrenInternal(
         child->setOwner(nullptr);
       }
       owner->setChildren(YGVector());
-      owner->markDirtyAndPropogate();
+      owner->markContentDirtyAndPropogate();
     }
   } else {
-    if (YGNodeGetChildCount(owner) > 0) {
-      for (YGNodeRef const oldChild : owner->getChildren()) {
-        // Our new children may have nodes in common with the old children. We
-        // don't reset these common nodes.
-        if (std::find(children.begin(), children.end(), oldChild) ==
-            children.end()) {
-          oldChild->setLayout(YGLayout());
-          oldChild->setOwner(nullptr);
-        }
-      }
+    // Our new children may have nodes in common with the old children. We
+    // don't reset these common nodes. Ownership marks them, which keeps a
+    // reorder linear instead of searching the new list per old child.
+    YGVector oldChildren = owner->getChildren();
+    for (YGNodeRef const oldChild : oldChildren) {
+      oldChild->setOwner(nullptr);
     }
     owner->setChildren(children);
+    bool hasDirtyBoundary = false;
     for (YGNodeRef child : children) {
       child->setOwner(owner);
+      hasDirtyBoundary = hasDirtyBoundary || child->hasDirtyBoundary();
+    }
+    for (YGNodeRef const oldChild : oldChildren) {
+      if (oldChild->getOwner() == nullptr) {
+        oldChild->setLayout(YGLayout());
+      }
+    }
+    owner->markContentDirtyAndPropogate();
+    if (hasDirtyBoundary) {
+      owner->markHasDirtyBoundaryAndPropogate();
     }
-    owner->markDirtyAndPropogate();
   }
 }
 
@@ -450,7 +483,7 @@ YOGA_EXPORT void YGNodeSetChildren(
     const YGNodeRef owner,
     const YGNodeRef c[],
     const uint32_t count) {
-  const YGVector children = {c, c + count};
+  const std::vector<YGNodeRef> children = {c, c + count};
   YGNodeSetChildrenInternal(owner, children);
 }
 
@@ -487,7 +520,7 @@ YOGA_EXPORT void YGNodeMarkDirty(const YGNodeRef node) {
       "Only leaf nodes with custom measure functions"
       "should manually mark themselves as dirty");
 
-  node->markDirtyAndPropogate();
+  node->markContentDirtyAndPropogate();
 }
 
 YOGA_EXPORT void YGNodeCopyStyle(
@@ -998,7 +1031,23 @@ YOGA_EXPORT bool YGNodeLayoutGetDidLegacyStretchFlagAffectLayout(
   return node->getLayout().doesLegacyStretchFlagAffectsLayout();
 }
 
-std::atomic<uint32_t> gCurrentGenerationCount(0);
+// Generations only have to differ from whatever a node in any tree recorded
+// last, they need no ordering. Each thread reserves a block at a time, so
+// roots laid out concurrently don't contend on one shared counter while a
+// subtree moved between roots still can't see its old generation again.
+static constexpr uint32_t kGenerationBlockSize = 1024;
+static std::atomic<uint32_t> gNextGenerationBlock(1);
+static thread_local uint32_t tNextGeneration = 0;
+static thread_local uint32_t tGenerationBlockEnd = 0;
+
+static uint32_t YGNextGeneration() {
+  if (tNextGeneration == tGenerationBlockEnd) {
+    tNextGeneration = gNextGenerationBlock.fetch_add(
+        kGenerationBlockSize, std::memory_order_relaxed);
+    tGenerationBlockEnd = tNextGeneration + kGenerationBlockSize;
+  }
+  return tNextGeneration++;
+}
 
 bool YGLayoutNodeInternal(
     const YGNodeRef node,
@@ -2069,6 +2118,123 @@ static YGCollectFlexItemsRowValues YGCalculateCollectFlexItemsRowValues(
 // of the flex items abide the min and max constraints. At the end of this
 // function the child nodes would have proper size. Prior using this function
 // please ensure that YGDistributeFreeSpaceFirstPass is called.
+// A final layout pass of one flex item, deferred so the independent
+// siblings of a line can be laid out in parallel.
+struct YGParallelLayoutJob {
+  YGNodeRef child;
+  float width;
+  float height;
+  YGMeasureMode widthMeasureMode;
+  YGMeasureMode heightMeasureMode;
+  LayoutData layoutData;
+};
+
+struct YGParallelLayoutBatch {
+  std::vector<YGParallelLayoutJob>* jobs;
+  YGDirection direction;
+  float availableInnerWidth;
+  float availableInnerHeight;
+  YGConfigRef config;
+  void* layoutContext;
+  uint32_t depth;
+  uint32_t generationCount;
+};
+
+static void YGRunParallelLayoutJob(
+    const YGParallelLayoutBatch& batch,
+    YGParallelLayoutJob& job,
+    LayoutData& layoutMarkerData) {
+  YGLayoutNodeInternal(
+      job.child,
+      job.width,
+      job.height,
+      batch.direction,
+      job.widthMeasureMode,
+      job.heightMeasureMode,
+      batch.availableInnerWidth,
+      batch.availableInnerHeight,
+      true,
+      LayoutPassReason::kFlexLayout,
+      batch.config,
+      layoutMarkerData,
+      batch.layoutContext,
+      batch.depth,
+      batch.generationCount);
+}
+
+static void YGMergeLayoutData(LayoutData& into, const LayoutData& from) {
+  into.layouts += from.layouts;
+  into.measures += from.measures;
+  into.maxMeasureCache = std::max(into.maxMeasureCache, from.maxMeasureCache);
+  into.cachedLayouts += from.cachedLayouts;
+  into.cachedMeasures += from.cachedMeasures;
+  into.measureCacheEvictions += from.measureCacheEvictions;
+  into.measureCallbacks += from.measureCallbacks;
+  for (size_t i = 0; i < into.measureCallbackReasonsCount.size(); i++) {
+    into.measureCallbackReasonsCount[i] += from.measureCallbackReasonsCount[i];
+  }
+}
+
+// Adds the nodes of the subtree to `nodeCount`. Returns false, and stops
+// early, if a node in it has a measure or baseline func: those call back into
+// the client and only ever run on the thread that started the layout.
+static bool YGCountParallelSubtree(const YGNodeRef node, size_t& nodeCount) {
+  if (node->hasMeasureFunc() || node->hasBaselineFunc()) {
+    return false;
+  }
+  nodeCount++;
+  for (const auto child : node->getChildren()) {
+    if (!YGCountParallelSubtree(child, nodeCount)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Each job only touches its own subtree. Subtrees with measure or baseline
+// funcs are laid out here, in order; so are all of them below the configured
+// size, where the scheduling overhead outweighs the gain.
+static void YGLayoutChildrenInParallel(
+    const YGNodeRef node,
+    const YGParallelLayoutBatch& batch,
+    LayoutData& layoutMarkerData) {
+  std::vector<YGParallelLayoutJob>& jobs = *batch.jobs;
+  size_t nodeCount = 0;
+  auto parallelEnd = std::stable_partition(
+      jobs.begin(), jobs.end(), [&nodeCount](const YGParallelLayoutJob& job) {
+        return YGCountParallelSubtree(job.child, nodeCount);
+      });
+  const size_t parallelCount = parallelEnd - jobs.begin();
+  if (parallelCount < 2 || nodeCount < batch.config->parallelLayoutThreshold) {
+    parallelEnd = jobs.begin();
+  }
+
+  for (auto job = parallelEnd; job != jobs.end(); ++job) {
+    YGRunParallelLayoutJob(batch, *job, layoutMarkerData);
+  }
+#ifdef THREADS_ENABLED
+  if (parallelEnd != jobs.begin()) {
+    Scheduler::get().parallelFor(
+        parallelEnd - jobs.begin(),
+        [](void* context, size_t index) {
+          const auto& batch = *static_cast<YGParallelLayoutBatch*>(context);
+          YGParallelLayoutJob& job = (*batch.jobs)[index];
+          job.layoutData = {};
+          YGRunParallelLayoutJob(batch, job, job.layoutData);
+        },
+        const_cast<YGParallelLayoutBatch*>(&batch));
+    for (auto job = jobs.begin(); job != parallelEnd; ++job) {
+      YGMergeLayoutData(layoutMarkerData, job->layoutData);
+    }
+  }
+#endif
+
+  for (const auto& job : jobs) {
+    node->setLayoutHadOverflow(
+        node->getLayout().hadOverflow() || job.child->getLayout().hadOverflow());
+  }
+}
+
 static float YGDistributeFreeSpaceSecondPass(
     YGCollectFlexItemsRowValues& collectedFlexItemsValues,
     const YGNodeRef node,
@@ -2094,6 +2260,15 @@ static float YGDistributeFreeSpaceSecondPass(
   const bool isMainAxisRow = YGFlexDirectionIsRow(mainAxis);
   const bool isNodeFlexWrap = node->getStyle().flexWrap() != YGWrapNoWrap;
 
+#ifdef THREADS_ENABLED
+  const bool deferLayouts = performLayout && config->parallelLayout &&
+      collectedFlexItemsValues.relativeChildren.size() > 1;
+#else
+  // Without threads there is nothing to run the jobs on.
+  const bool deferLayouts = false;
+#endif
+  std::vector<YGParallelLayoutJob> deferredLayouts;
+
   for (auto currentRelativeChild : collectedFlexItemsValues.relativeChildren) {
     childFlexBasis = YGNodeBoundAxisWithinMinAndMax(
                          currentRelativeChild,
@@ -2238,6 +2413,16 @@ static float YGDistributeFreeSpaceSecondPass(
         !isMainAxisRow ? childMainMeasureMode : childCrossMeasureMode;
 
     const bool isLayoutPass = performLayout && !requiresStretchLayout;
+    if (deferLayouts && isLayoutPass) {
+      deferredLayouts.push_back(
+          {currentRelativeChild,
+           childWidth,
+           childHeight,
+           childWidthMeasureMode,
+           childHeightMeasureMode,
+           {}});
+      continue;
+    }
     // Recursively call the layout algorithm for this child with the updated
     // main size.
     YGLayoutNodeInternal(
@@ -2261,6 +2446,19 @@ static float YGDistributeFreeSpaceSecondPass(
         node->getLayout().hadOverflow() ||
         currentRelativeChild->getLayout().hadOverflow());
   }
+
+  if (!deferredLayouts.empty()) {
+    const YGParallelLayoutBatch batch = {
+        &deferredLayouts,
+        node->getLayout().direction(),
+        availableInnerWidth,
+        availableInnerHeight,
+        config,
+        layoutContext,
+        depth,
+        generationCount};
+    YGLayoutChildrenInParallel(node, batch, layoutMarkerData);
+  }
   return deltaFreeSpace;
 }
 
@@ -2539,7 +2737,7 @@ static void YGJustifyMainAxis(
        i++) {
     const YGNodeRef child = node->getChild(i);
     const YGStyle& childStyle = child->getStyle();
-    const YGLayout childLayout = child->getLayout();
+    const YGLayout& childLayout = child->getLayout();
     const bool isLastChild = i == collectedFlexItemsValues.endOfLineIndex - 1;
     // remove the gap if it is the last element of the line
     if (isLastChild) {
@@ -3789,6 +3987,22 @@ YOGA_EXPORT bool YGNodeCanUseCachedMeasurement(
   return widthIsCompatible && heightIsCompatible;
 }
 
+// Returns the measurement cache entry that was hit. Under the LRU policy the
+// entry is moved to the front so the least recently used one is evicted first.
+// The cache settings come from the config of the layout root, so they apply
+// to the whole tree.
+static YGCachedMeasurement* YGUseCachedMeasurement(
+    const YGNodeRef node,
+    const YGConfigRef config,
+    const uint32_t index) {
+  YGLayout* layout = &node->getLayout();
+  if (config->measurementCachePolicy != YGMeasurementCachePolicyLRU) {
+    return &layout->cachedMeasurement(index);
+  }
+  layout->promoteCachedMeasurement(index);
+  return &layout->cachedMeasurement(0);
+}
+
 //
 // This is a wrapper around the YGNodelayoutImpl function. It determines whether
 // the layout request is redundant and can be skipped.
@@ -3872,16 +4086,16 @@ bool YGLayoutNodeInternal(
                 availableWidth,
                 heightMeasureMode,
                 availableHeight,
-                layout->cachedMeasurements[i].widthMeasureMode,
-                layout->cachedMeasurements[i].availableWidth,
-                layout->cachedMeasurements[i].heightMeasureMode,
-                layout->cachedMeasurements[i].availableHeight,
-                layout->cachedMeasurements[i].computedWidth,
-                layout->cachedMeasurements[i].computedHeight,
+                layout->cachedMeasurement(i).widthMeasureMode,
+                layout->cachedMeasurement(i).availableWidth,
+                layout->cachedMeasurement(i).heightMeasureMode,
+                layout->cachedMeasurement(i).availableHeight,
+                layout->cachedMeasurement(i).computedWidth,
+                layout->cachedMeasurement(i).computedHeight,
                 marginAxisRow,
                 marginAxisColumn,
                 config)) {
-          cachedResults = &layout->cachedMeasurements[i];
+          cachedResults = YGUseCachedMeasurement(node, config, i);
           break;
         }
       }
@@ -3896,13 +4110,13 @@ bool YGLayoutNodeInternal(
   } else {
     for (uint32_t i = 0; i < layout->nextCachedMeasurementsIndex; i++) {
       if (YGFloatsEqual(
-              layout->cachedMeasurements[i].availableWidth, availableWidth) &&
+              layout->cachedMeasurement(i).availableWidth, availableWidth) &&
           YGFloatsEqual(
-              layout->cachedMeasurements[i].availableHeight, availableHeight) &&
-          layout->cachedMeasurements[i].widthMeasureMode == widthMeasureMode &&
-          layout->cachedMeasurements[i].heightMeasureMode ==
+              layout->cachedMeasurement(i).availableHeight, availableHeight) &&
+          layout->cachedMeasurement(i).widthMeasureMode == widthMeasureMode &&
+          layout->cachedMeasurement(i).heightMeasureMode ==
               heightMeasureMode) {
-        cachedResults = &layout->cachedMeasurements[i];
+        cachedResults = YGUseCachedMeasurement(node, config, i);
         break;
       }
     }
@@ -4008,23 +4222,44 @@ bool YGLayoutNodeInternal(
         layoutMarkerData.maxMeasureCache =
             layout->nextCachedMeasurementsIndex + 1;
       }
-      if (layout->nextCachedMeasurementsIndex == YG_MAX_CACHED_RESULT_COUNT) {
+      const bool lru =
+          config->measurementCachePolicy == YGMeasurementCachePolicyLRU;
+      const uint32_t cacheSize = config->measurementCacheSize;
+      if (!lru && layout->nextCachedMeasurementsIndex >= cacheSize) {
         if (gPrintChanges) {
           Log::log(node, YGLogLevelVerbose, nullptr, "Out of cache entries!\n");
         }
+        layoutMarkerData.measureCacheEvictions +=
+            layout->nextCachedMeasurementsIndex;
         layout->nextCachedMeasurementsIndex = 0;
       }
 
+      const bool ownedOutOfLine = layout->ownsOutOfLineStorage();
       YGCachedMeasurement* newCacheEntry;
       if (performLayout) {
         // Use the single layout cache entry.
         newCacheEntry = &layout->cachedLayout;
+      } else if (lru) {
+        // The least recently used entry is the last one, recycle it as the
+        // new front.
+        if (layout->nextCachedMeasurementsIndex >= cacheSize) {
+          layoutMarkerData.measureCacheEvictions +=
+              layout->nextCachedMeasurementsIndex - cacheSize + 1;
+          layout->nextCachedMeasurementsIndex = cacheSize - 1;
+        }
+        layout->promoteCachedMeasurement(layout->nextCachedMeasurementsIndex);
+        newCacheEntry = &layout->cachedMeasurement(0);
+        layout->nextCachedMeasurementsIndex++;
       } else {
         // Allocate a new measurement cache entry.
         newCacheEntry =
-            &layout->cachedMeasurements[layout->nextCachedMeasurementsIndex];
+            &layout->cachedMeasurement(layout->nextCachedMeasurementsIndex);
         layout->nextCachedMeasurementsIndex++;
       }
+      // The arena, if any, only learns once that this node needs destroying.
+      if (!ownedOutOfLine && layout->ownsOutOfLineStorage()) {
+        node->noteOutOfLineStorage();
+      }
 
       newCacheEntry->availableWidth = availableWidth;
       newCacheEntry->availableHeight = availableHeight;
@@ -4082,76 +4317,369 @@ YOGA_EXPORT void YGConfigSetPointScaleFactor(
   }
 }
 
-static void YGRoundToPixelGrid(
+YOGA_EXPORT float YGConfigGetPointScaleFactor(const YGConfigRef config) {
+  return config->pointScaleFactor;
+}
+
+// Rounding modes of YGRoundValuesToPixelGrid, matching the forceCeil and
+// forceFloor arguments of YGRoundValueToPixelGrid.
+enum YGPixelGridRounding : uint8_t {
+  kPixelGridNearest,
+  kPixelGridCeil,
+  kPixelGridFloor,
+};
+
+// YGRoundValueToPixelGrid over flat arrays. The loop has no calls besides
+// floor (a single instruction with SSE4.1/NEON) and no data dependent
+// branches, so compilers vectorize it.
+static void YGRoundValuesToPixelGrid(
+    const double* values,
+    const uint8_t* modes,
+    float* rounded,
+    const size_t count,
+    const double pointScaleFactor) {
+  for (size_t i = 0; i < count; i++) {
+    const double scaledValue = values[i] * pointScaleFactor;
+    const double base = std::floor(scaledValue);
+    // In [0, 1) for negative values as well, unlike fmod.
+    const double fractial = scaledValue - base;
+    const bool nearZero = fractial < 0.0001;
+    const bool nearOne = fractial > 1.0 - 0.0001;
+    const bool roundUp = nearOne ||
+        (!nearZero &&
+         (modes[i] == kPixelGridCeil ||
+          (modes[i] != kPixelGridFloor && fractial > 0.5 - 0.0001)));
+    rounded[i] = static_cast<float>(
+        (base + (roundUp ? 1.0 : 0.0)) / pointScaleFactor);
+  }
+}
+
+namespace {
+
+// Per node: left, top, then the absolute left, top, right and bottom edges.
+constexpr size_t kPixelGridValuesPerNode = 6;
+
+struct YGPixelGridScratch {
+  std::vector<YGNodeRef> nodes;
+  std::vector<double> values;
+  std::vector<uint8_t> modes;
+  std::vector<float> rounded;
+};
+
+} // namespace
+
+static bool YGHasFractionalPixels(const double value) {
+  const double fractial = value - std::floor(value);
+  return !YGDoubleEqual(fractial, 0) && !YGDoubleEqual(fractial, 1.0);
+}
+
+// Only subtrees visited by the pass of `generationCount`, or whose owner moved
+// since they were last rounded, are collected. The others keep the values
+// rounding them again would give.
+static void YGCollectPixelGridValues(
     const YGNodeRef node,
     const double pointScaleFactor,
     const double absoluteLeft,
-    const double absoluteTop) {
-  if (pointScaleFactor == 0.0f) {
-    return;
+    const double absoluteTop,
+    const uint32_t generationCount,
+    YGPixelGridScratch& scratch) {
+  YGLayout& layout = node->getLayout();
+  auto& source = layout.pixelGridSource;
+  // Nodes the pass did not lay out hold rounded values, the unrounded ones
+  // are only left in their source.
+  if (layout.generationCount == generationCount ||
+      YGFloatIsUndefined(source.left)) {
+    source.left = layout.position[YGEdgeLeft];
+    source.top = layout.position[YGEdgeTop];
+    source.width = layout.dimensions[YGDimensionWidth];
+    source.height = layout.dimensions[YGDimensionHeight];
   }
+  source.ownerLeft = absoluteLeft;
+  source.ownerTop = absoluteTop;
 
-  const double nodeLeft = node->getLayout().position[YGEdgeLeft];
-  const double nodeTop = node->getLayout().position[YGEdgeTop];
+  const double nodeLeft = source.left;
+  const double nodeTop = source.top;
 
-  const double nodeWidth = node->getLayout().dimensions[YGDimensionWidth];
-  const double nodeHeight = node->getLayout().dimensions[YGDimensionHeight];
+  const double nodeWidth = source.width;
+  const double nodeHeight = source.height;
 
   const double absoluteNodeLeft = absoluteLeft + nodeLeft;
   const double absoluteNodeTop = absoluteTop + nodeTop;
 
-  const double absoluteNodeRight = absoluteNodeLeft + nodeWidth;
-  const double absoluteNodeBottom = absoluteNodeTop + nodeHeight;
-
   // If a node has a custom measure function we never want to round down its
   // size as this could lead to unwanted text truncation.
   const bool textRounding = node->getNodeType() == YGNodeTypeText;
+  const uint8_t edgeMode =
+      textRounding ? kPixelGridFloor : kPixelGridNearest;
+  const uint8_t widthMode = !textRounding ? kPixelGridNearest
+      : YGHasFractionalPixels(nodeWidth * pointScaleFactor)
+      ? kPixelGridCeil
+      : kPixelGridFloor;
+  const uint8_t heightMode = !textRounding ? kPixelGridNearest
+      : YGHasFractionalPixels(nodeHeight * pointScaleFactor)
+      ? kPixelGridCeil
+      : kPixelGridFloor;
+
+  scratch.nodes.push_back(node);
+  scratch.values.insert(
+      scratch.values.end(),
+      {nodeLeft,
+       nodeTop,
+       absoluteNodeLeft,
+       absoluteNodeTop,
+       absoluteNodeLeft + nodeWidth,
+       absoluteNodeTop + nodeHeight});
+  scratch.modes.insert(
+      scratch.modes.end(),
+      {edgeMode, edgeMode, edgeMode, edgeMode, widthMode, heightMode});
+
+  for (const auto child : node->getChildren()) {
+    const YGLayout& childLayout = child->getLayout();
+    if (childLayout.generationCount == generationCount ||
+        childLayout.pixelGridSource.ownerLeft != absoluteNodeLeft ||
+        childLayout.pixelGridSource.ownerTop != absoluteNodeTop) {
+      YGCollectPixelGridValues(
+          child,
+          pointScaleFactor,
+          absoluteNodeLeft,
+          absoluteNodeTop,
+          generationCount,
+          scratch);
+    }
+  }
+}
 
-  node->setLayoutPosition(
-      YGRoundValueToPixelGrid(nodeLeft, pointScaleFactor, false, textRounding),
-      YGEdgeLeft);
+static void YGRoundToPixelGrid(
+    const YGNodeRef node,
+    const double pointScaleFactor,
+    const double absoluteLeft,
+    const double absoluteTop,
+    const uint32_t generationCount) {
+  if (pointScaleFactor == 0.0f) {
+    return;
+  }
 
-  node->setLayoutPosition(
-      YGRoundValueToPixelGrid(nodeTop, pointScaleFactor, false, textRounding),
-      YGEdgeTop);
+  // Reused across passes, layouts may run on several threads at once.
+  static thread_local YGPixelGridScratch scratch;
+  scratch.nodes.clear();
+  scratch.values.clear();
+  scratch.modes.clear();
+  YGCollectPixelGridValues(
+      node,
+      pointScaleFactor,
+      absoluteLeft,
+      absoluteTop,
+      generationCount,
+      scratch);
+
+  // Everything is read before anything is written, children are collected
+  // from the unrounded position of their owner.
+  scratch.rounded.resize(scratch.values.size());
+  YGRoundValuesToPixelGrid(
+      scratch.values.data(),
+      scratch.modes.data(),
+      scratch.rounded.data(),
+      scratch.values.size(),
+      pointScaleFactor);
+
+  const float* rounded = scratch.rounded.data();
+  for (const auto roundedNode : scratch.nodes) {
+    roundedNode->setLayoutPosition(rounded[0], YGEdgeLeft);
+    roundedNode->setLayoutPosition(rounded[1], YGEdgeTop);
+    roundedNode->setLayoutDimension(rounded[4] - rounded[2], YGDimensionWidth);
+    roundedNode->setLayoutDimension(
+        rounded[5] - rounded[3], YGDimensionHeight);
+    rounded += kPixelGridValuesPerNode;
+  }
+}
 
-  // We multiply dimension by scale factor and if the result is close to the
-  // whole number, we don't have any fraction To verify if the result is close
-  // to whole number we want to check both floor and ceil numbers
-  const bool hasFractionalWidth =
-      !YGDoubleEqual(fmod(nodeWidth * pointScaleFactor, 1.0), 0) &&
-      !YGDoubleEqual(fmod(nodeWidth * pointScaleFactor, 1.0), 1.0);
-  const bool hasFractionalHeight =
-      !YGDoubleEqual(fmod(nodeHeight * pointScaleFactor, 1.0), 0) &&
-      !YGDoubleEqual(fmod(nodeHeight * pointScaleFactor, 1.0), 1.0);
-
-  node->setLayoutDimension(
-      YGRoundValueToPixelGrid(
-          absoluteNodeRight,
-          pointScaleFactor,
-          (textRounding && hasFractionalWidth),
-          (textRounding && !hasFractionalWidth)) -
-          YGRoundValueToPixelGrid(
-              absoluteNodeLeft, pointScaleFactor, false, textRounding),
-      YGDimensionWidth);
+// Clears the flags below `node` and collects, in pre-order, the dirty children
+// of clean owners. Those that stopped being boundaries since they were marked,
+// or were never laid out, dirty their ancestors now so the regular pass takes
+// them.
+static void YGCollectDirtyBoundaries(
+    const YGNodeRef node,
+    std::vector<YGNodeRef>& boundaries) {
+  node->setHasDirtyBoundary(false);
+  for (const auto child : node->getChildren()) {
+    if (child->getStyle().display() == YGDisplayNone) {
+      continue;
+    }
+    if (child->isDirty() && !node->isDirty()) {
+      if (child->isLayoutBoundary() &&
+          child->getLayout().cachedLayout.computedWidth >= 0) {
+        boundaries.push_back(child);
+      } else {
+        node->markContentDirtyAndPropogate();
+      }
+    }
+    if (child->hasDirtyBoundary()) {
+      YGCollectDirtyBoundaries(child, boundaries);
+    }
+  }
+}
 
-  node->setLayoutDimension(
-      YGRoundValueToPixelGrid(
-          absoluteNodeBottom,
-          pointScaleFactor,
-          (textRounding && hasFractionalHeight),
-          (textRounding && !hasFractionalHeight)) -
-          YGRoundValueToPixelGrid(
-              absoluteNodeTop, pointScaleFactor, false, textRounding),
-      YGDimensionHeight);
+// Lays the subtree of a boundary out again with the constraints its owner
+// gave it last time. Its own rect cannot have changed; with a pixel grid, the
+// subtree is rounded from the unrounded origin the last full pass left in its
+// pixel grid source, so it lands where laying out the whole tree would put it.
+static void YGLayoutDirtyBoundary(
+    const YGNodeRef node,
+    const YGConfigRef config,
+    LayoutData& layoutMarkerData,
+    void* const layoutContext,
+    const uint32_t generationCount) {
+  const YGLayout& layout = node->getLayout();
+  const YGCachedMeasurement constraints = layout.cachedLayout;
+  const float width = layout.dimensions[YGDimensionWidth];
+  const float height = layout.dimensions[YGDimensionHeight];
+  const YGLayout::PixelGridSource source = layout.pixelGridSource;
+
+  const YGLayout& ownerLayout = node->getOwner()->getLayout();
+  const float ownerWidth = ownerLayout.dimensions[YGDimensionWidth] -
+      ownerLayout.padding[YGEdgeLeft] - ownerLayout.padding[YGEdgeRight] -
+      ownerLayout.border[YGEdgeLeft] - ownerLayout.border[YGEdgeRight];
+  const float ownerHeight = ownerLayout.dimensions[YGDimensionHeight] -
+      ownerLayout.padding[YGEdgeTop] - ownerLayout.padding[YGEdgeBottom] -
+      ownerLayout.border[YGEdgeTop] - ownerLayout.border[YGEdgeBottom];
 
-  const uint32_t childCount = YGNodeGetChildCount(node);
-  for (uint32_t i = 0; i < childCount; i++) {
+  YGLayoutNodeInternal(
+      node,
+      constraints.availableWidth,
+      constraints.availableHeight,
+      layout.lastOwnerDirection,
+      constraints.widthMeasureMode,
+      constraints.heightMeasureMode,
+      ownerWidth,
+      ownerHeight,
+      true,
+      LayoutPassReason::kInitial,
+      config,
+      layoutMarkerData,
+      layoutContext,
+      0,
+      generationCount);
+
+  if (!YGFloatIsUndefined(source.left)) {
+    node->setLayoutPosition(source.left, YGEdgeLeft);
+    node->setLayoutPosition(source.top, YGEdgeTop);
+    YGRoundToPixelGrid(
+        node,
+        config->pointScaleFactor,
+        source.ownerLeft,
+        source.ownerTop,
+        generationCount);
+  } else {
     YGRoundToPixelGrid(
-        YGNodeGetChild(node, i),
-        pointScaleFactor,
-        absoluteNodeLeft,
-        absoluteNodeTop);
+        node, config->pointScaleFactor, 0.0, 0.0, generationCount);
+  }
+  node->setLayoutDimension(width, YGDimensionWidth);
+  node->setLayoutDimension(height, YGDimensionHeight);
+}
+
+static void YGWriteLayoutBuffer(
+    const YGNodeRef node,
+    const int32_t parentId,
+    YGLayoutBuffer* buffer) {
+  const uint32_t id = buffer->count++;
+  if (id < buffer->capacity) {
+    const YGLayout& layout = node->getLayout();
+    if (buffer->left != nullptr) {
+      buffer->left[id] = layout.position[YGEdgeLeft];
+    }
+    if (buffer->top != nullptr) {
+      buffer->top[id] = layout.position[YGEdgeTop];
+    }
+    if (buffer->width != nullptr) {
+      buffer->width[id] = layout.dimensions[YGDimensionWidth];
+    }
+    if (buffer->height != nullptr) {
+      buffer->height[id] = layout.dimensions[YGDimensionHeight];
+    }
+    if (buffer->parent != nullptr) {
+      buffer->parent[id] = parentId;
+    }
+    if (buffer->direction != nullptr) {
+      buffer->direction[id] = static_cast<uint8_t>(layout.direction());
+    }
+    if (buffer->hadOverflow != nullptr) {
+      buffer->hadOverflow[id] = layout.hadOverflow() ? 1 : 0;
+    }
+    if (buffer->right != nullptr) {
+      buffer->right[id] = layout.position[YGEdgeRight];
+    }
+    if (buffer->bottom != nullptr) {
+      buffer->bottom[id] = layout.position[YGEdgeBottom];
+    }
+    for (size_t edge = 0; edge < 4; edge++) {
+      if (buffer->margin[edge] != nullptr) {
+        buffer->margin[edge][id] = layout.margin[edge];
+      }
+      if (buffer->border[edge] != nullptr) {
+        buffer->border[edge][id] = layout.border[edge];
+      }
+      if (buffer->padding[edge] != nullptr) {
+        buffer->padding[edge][id] = layout.padding[edge];
+      }
+    }
+  }
+  for (const auto child : node->getChildren()) {
+    YGWriteLayoutBuffer(child, static_cast<int32_t>(id), buffer);
+  }
+}
+
+static uint32_t YGCountNodes(const YGNodeRef node) {
+  uint32_t count = 1;
+  for (const auto child : node->getChildren()) {
+    count += YGCountNodes(child);
+  }
+  return count;
+}
+
+static void YGReadLayoutBuffer(
+    const YGNodeRef node,
+    const YGLayoutBuffer* buffer,
+    uint32_t& nextId) {
+  const uint32_t id = nextId++;
+  // A fresh layout has no cache entries, the old ones may have been measured
+  // with a different style.
+  YGLayout layout;
+  layout.position[YGEdgeLeft] = buffer->left[id];
+  layout.position[YGEdgeTop] = buffer->top[id];
+  layout.dimensions[YGDimensionWidth] = buffer->width[id];
+  layout.dimensions[YGDimensionHeight] = buffer->height[id];
+  layout.measuredDimensions = layout.dimensions;
+  // Buffers may come from storage, an unknown direction is inherited.
+  if (buffer->direction != nullptr &&
+      buffer->direction[id] < enums::count<YGDirection>()) {
+    layout.setDirection(static_cast<YGDirection>(buffer->direction[id]));
+  }
+  if (buffer->hadOverflow != nullptr) {
+    layout.setHadOverflow(buffer->hadOverflow[id] != 0);
+  }
+  if (buffer->right != nullptr) {
+    layout.position[YGEdgeRight] = buffer->right[id];
+  }
+  if (buffer->bottom != nullptr) {
+    layout.position[YGEdgeBottom] = buffer->bottom[id];
+  }
+  for (size_t edge = 0; edge < 4; edge++) {
+    if (buffer->margin[edge] != nullptr) {
+      layout.margin[edge] = buffer->margin[edge][id];
+    }
+    if (buffer->border[edge] != nullptr) {
+      layout.border[edge] = buffer->border[edge][id];
+    }
+    if (buffer->padding[edge] != nullptr) {
+      layout.padding[edge] = buffer->padding[edge][id];
+    }
+  }
+  node->setLayout(layout);
+  node->setHasNewLayout(true);
+  node->setDirty(false);
+  node->setHasDirtyBoundary(false);
+  for (const auto child : node->getChildren()) {
+    YGReadLayoutBuffer(child, buffer, nextId);
   }
 }
 
@@ -4168,14 +4696,31 @@ YOGA_EXPORT void YGNodeCalculateLayoutWithContext(
     const float ownerHeight,
     const YGDirection ownerDirection,
     void* layoutContext) {
+  facebook::yoga::calculateLayoutWithData(
+      node, ownerWidth, ownerHeight, ownerDirection, layoutContext, nullptr);
+}
+
+void facebook::yoga::calculateLayoutWithData(
+    const YGNodeRef node,
+    const float ownerWidth,
+    const float ownerHeight,
+    const YGDirection ownerDirection,
+    void* layoutContext,
+    LayoutData* layoutData) {
 
   Event::publish<Event::LayoutPassStart>(node, {layoutContext});
   LayoutData markerData = {};
 
-  // Increment the generation count. This will force the recursive routine to
+  // Re-collect if a former boundary dirtied a node already walked past.
+  std::vector<YGNodeRef> dirtyBoundaries;
+  while (node->hasDirtyBoundary()) {
+    YGCollectDirtyBoundaries(node, dirtyBoundaries);
+  }
+
+  // Take a fresh generation. This will force the recursive routine to
   // visit all dirty nodes at least once. Subsequent visits will be skipped if
   // the input parameters don't change.
-  gCurrentGenerationCount.fetch_add(1, std::memory_order_relaxed);
+  const uint32_t generationCount = YGNextGeneration();
   node->resolveDimension();
   float width = YGUndefined;
   YGMeasureMode widthMeasureMode = YGMeasureModeUndefined;
@@ -4232,10 +4777,11 @@ YOGA_EXPORT void YGNodeCalculateLayoutWithContext(
           markerData,
           layoutContext,
           0, // tree root
-          gCurrentGenerationCount.load(std::memory_order_relaxed))) {
+          generationCount)) {
     node->setPosition(
         node->getLayout().direction(), ownerWidth, ownerHeight, ownerWidth);
-    YGRoundToPixelGrid(node, node->getConfig()->pointScaleFactor, 0.0f, 0.0f);
+    YGRoundToPixelGrid(
+        node, node->getConfig()->pointScaleFactor, 0.0, 0.0, generationCount);
 
 #ifdef DEBUG
     if (node->getConfig()->printTree) {
@@ -4246,7 +4792,23 @@ YOGA_EXPORT void YGNodeCalculateLayoutWithContext(
 #endif
   }
 
+  // Boundaries under owners the pass did not reach, nested ones are laid out
+  // by the outermost.
+  for (const auto boundary : dirtyBoundaries) {
+    if (boundary->isDirty() && !boundary->getOwner()->isDirty()) {
+      YGLayoutDirtyBoundary(
+          boundary,
+          node->getConfig(),
+          markerData,
+          layoutContext,
+          generationCount);
+    }
+  }
+
   Event::publish<Event::LayoutPassEnd>(node, {layoutContext, &markerData});
+  if (layoutData != nullptr) {
+    *layoutData = markerData;
+  }
 
   // We want to get rid off `useLegacyStretchBehaviour` from YGConfig. But we
   // aren't sure whether client's of yoga have gotten rid off this flag or not.
@@ -4261,7 +4823,7 @@ YOGA_EXPORT void YGNodeCalculateLayoutWithContext(
     nodeWithoutLegacyFlag->resolveDimension();
     // Recursively mark nodes as dirty
     nodeWithoutLegacyFlag->markDirtyAndPropogateDownwards();
-    gCurrentGenerationCount.fetch_add(1, std::memory_order_relaxed);
+    const uint32_t diffGenerationCount = YGNextGeneration();
     // Rerun the layout, and calculate the diff
     unsetUseLegacyFlagRecursively(nodeWithoutLegacyFlag);
     LayoutData layoutMarkerData = {};
@@ -4280,7 +4842,7 @@ YOGA_EXPORT void YGNodeCalculateLayoutWithContext(
             layoutMarkerData,
             layoutContext,
             0, // tree root
-            gCurrentGenerationCount.load(std::memory_order_relaxed))) {
+            diffGenerationCount)) {
       nodeWithoutLegacyFlag->setPosition(
           nodeWithoutLegacyFlag->getLayout().direction(),
           ownerWidth,
@@ -4289,8 +4851,9 @@ YOGA_EXPORT void YGNodeCalculateLayoutWithContext(
       YGRoundToPixelGrid(
           nodeWithoutLegacyFlag,
           nodeWithoutLegacyFlag->getConfig()->pointScaleFactor,
-          0.0f,
-          0.0f);
+          0.0,
+          0.0,
+          diffGenerationCount);
 
       // Set whether the two layouts are different or not.
       auto neededLegacyStretchBehaviour =
@@ -4319,6 +4882,41 @@ YOGA_EXPORT void YGNodeCalculateLayout(
       node, ownerWidth, ownerHeight, ownerDirection, nullptr);
 }
 
+YOGA_EXPORT void YGNodeCopyLayoutToBuffer(
+    const YGNodeRef node,
+    YGLayoutBuffer* buffer) {
+  buffer->count = 0;
+  YGWriteLayoutBuffer(node, -1, buffer);
+}
+
+YOGA_EXPORT void YGNodeAppendLayoutToBuffer(
+    const YGNodeRef node,
+    YGLayoutBuffer* buffer) {
+  YGWriteLayoutBuffer(node, -1, buffer);
+}
+
+YOGA_EXPORT bool YGNodeApplyLayoutFromBuffer(
+    const YGNodeRef node,
+    const YGLayoutBuffer* buffer) {
+  if (buffer->count != YGCountNodes(node)) {
+    return false;
+  }
+  uint32_t nextId = 0;
+  YGReadLayoutBuffer(node, buffer, nextId);
+  return true;
+}
+
+YOGA_EXPORT void YGNodeCalculateLayoutIntoBuffer(
+    const YGNodeRef node,
+    const float ownerWidth,
+    const float ownerHeight,
+    const YGDirection ownerDirection,
+    YGLayoutBuffer* buffer) {
+  YGNodeCalculateLayoutWithContext(
+      node, ownerWidth, ownerHeight, ownerDirection, nullptr);
+  YGNodeCopyLayoutToBuffer(node, buffer);
+}
+
 YOGA_EXPORT void YGConfigSetLogger(const YGConfigRef config, YGLogger logger) {
   if (logger != nullptr) {
     config->setLogger(logger);
@@ -4398,6 +4996,93 @@ bool YGConfigGetUseWebDefaults(const YGConfigRef config) {
   return config->useWebDefaults;
 }
 
+YOGA_EXPORT void YGConfigSetParallelLayout(
+    const YGConfigRef config,
+    const bool enabled) {
+  config->parallelLayout = enabled;
+}
+
+YOGA_EXPORT bool YGConfigGetParallelLayout(const YGConfigRef config) {
+  return config->parallelLayout;
+}
+
+YOGA_EXPORT void YGConfigSetParallelLayoutThreshold(
+    const YGConfigRef config,
+    const uint32_t threshold) {
+  config->parallelLayoutThreshold = threshold;
+}
+
+YOGA_EXPORT uint32_t
+YGConfigGetParallelLayoutThreshold(const YGConfigRef config) {
+  return config->parallelLayoutThreshold;
+}
+
+YOGA_EXPORT void YGConfigSetLayoutBoundaries(
+    const YGConfigRef config,
+    const bool enabled) {
+  config->layoutBoundaries = enabled;
+}
+
+YOGA_EXPORT bool YGConfigGetLayoutBoundaries(const YGConfigRef config) {
+  return config->layoutBoundaries;
+}
+
+YOGA_EXPORT void YGConfigSetMeasurementCacheSize(
+    const YGConfigRef config,
+    const uint32_t size) {
+  config->measurementCacheSize =
+      std::min(std::max(size, 1u), (uint32_t) YG_MAX_CACHED_RESULT_COUNT);
+}
+
+YOGA_EXPORT uint32_t YGConfigGetMeasurementCacheSize(const YGConfigRef config) {
+  return config->measurementCacheSize;
+}
+
+YOGA_EXPORT void YGConfigSetMeasurementCachePolicy(
+    const YGConfigRef config,
+    const YGMeasurementCachePolicy policy) {
+  config->measurementCachePolicy = policy;
+}
+
+YOGA_EXPORT YGMeasurementCachePolicy
+YGConfigGetMeasurementCachePolicy(const YGConfigRef config) {
+  return config->measurementCachePolicy;
+}
+
+YOGA_EXPORT YGNodeArenaRef YGNodeArenaNew(void) {
+  return new YGNodeArena();
+}
+
+YOGA_EXPORT void YGNodeArenaFree(const YGNodeArenaRef arena) {
+  delete arena;
+}
+
+YOGA_EXPORT void YGNodeArenaReset(const YGNodeArenaRef arena) {
+  arena->reset();
+}
+
+YOGA_EXPORT void YGConfigSetNodeArena(
+    const YGConfigRef config,
+    const YGNodeArenaRef arena) {
+  config->nodeArena = arena;
+}
+
+YOGA_EXPORT YGNodeArenaRef YGConfigGetNodeArena(const YGConfigRef config) {
+  return config->nodeArena;
+}
+
+YOGA_EXPORT void YGNodeSetConfig(const YGNodeRef node, const YGConfigRef config) {
+  YGAssertWithConfig(
+      config,
+      config->useWebDefaults == node->getConfig()->useWebDefaults,
+      "UseWebDefaults may not be changed after constructing a YGNode");
+  node->setConfig(config);
+}
+
+YOGA_EXPORT YGConfigRef YGNodeGetConfig(const YGNodeRef node) {
+  return node->getConfig();
+}
+
 YOGA_EXPORT void YGConfigSetContext(const YGConfigRef config, void* context) {
   config->context = context;
 }
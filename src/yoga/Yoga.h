@@ -32,8 +32,33 @@ typedef struct YGSize {
 typedef struct YGConfig* YGConfigRef;
 
 typedef struct YGNode* YGNodeRef;
+typedef struct YGNodeArena* YGNodeArenaRef;
 typedef const struct YGNode* YGNodeConstRef;
 
+// Caller owned structure-of-arrays copy of a laid out tree, indexed by
+// pre-order node id. Each non-null array holds `capacity` entries; positions
+// are relative to the owner and `parent` receives the id of each node's
+// owner, -1 for the node a copy started from. `margin`, `border` and
+// `padding` are indexed by YGEdgeLeft, YGEdgeTop, YGEdgeRight and
+// YGEdgeBottom. `count` is set to the number of nodes copied, when it exceeds
+// `capacity` only the first `capacity` nodes are written.
+typedef struct YGLayoutBuffer {
+  float* left;
+  float* top;
+  float* width;
+  float* height;
+  int32_t* parent;
+  uint8_t* direction;
+  uint8_t* hadOverflow;
+  float* right;
+  float* bottom;
+  float* margin[4];
+  float* border[4];
+  float* padding[4];
+  uint32_t capacity;
+  uint32_t count;
+} YGLayoutBuffer;
+
 typedef YGSize (*YGMeasureFunc)(
     YGNodeRef node,
     float width,
@@ -97,6 +122,37 @@ WIN_EXPORT void YGNodeCalculateLayout(
     float availableHeight,
     YGDirection ownerDirection);
 
+// Same as YGNodeCalculateLayout, then copies the final, rounded rects of the
+// whole tree into `buffer`.
+WIN_EXPORT void YGNodeCalculateLayoutIntoBuffer(
+    YGNodeRef node,
+    float availableWidth,
+    float availableHeight,
+    YGDirection ownerDirection,
+    YGLayoutBuffer* buffer);
+
+// Copies the current layout of the tree into `buffer` without laying it out,
+// the root at 0.
+WIN_EXPORT void YGNodeCopyLayoutToBuffer(
+    YGNodeRef node,
+    YGLayoutBuffer* buffer);
+
+// Same, from id `count` on, leaving the nodes already in `buffer` alone.
+WIN_EXPORT void YGNodeAppendLayoutToBuffer(
+    YGNodeRef node,
+    YGLayoutBuffer* buffer);
+
+// Gives a tree of the same shape a layout read earlier with
+// YGNodeCopyLayoutToBuffer, without laying it out. `left`, `top`, `width` and
+// `height` must be set; values whose array is null are reset, to an inherited
+// direction and zero for the others. The nodes are marked clean and their
+// caches are
+// dropped, so the pass after the next edit lays them out from scratch.
+// Returns false and leaves the tree alone when `count` is not its node count.
+WIN_EXPORT bool YGNodeApplyLayoutFromBuffer(
+    YGNodeRef node,
+    const YGLayoutBuffer* buffer);
+
 // Mark a node as dirty. Only valid for nodes with a custom measure function
 // set.
 //
@@ -147,6 +203,8 @@ WIN_EXPORT void YGNodeSetHasNewLayout(YGNodeRef node, bool hasNewLayout);
 YGNodeType YGNodeGetNodeType(YGNodeRef node);
 void YGNodeSetNodeType(YGNodeRef node, YGNodeType nodeType);
 WIN_EXPORT bool YGNodeIsDirty(YGNodeRef node);
+// Dirty, or a dirty layout boundary waits below the node.
+WIN_EXPORT bool YGNodeNeedsLayout(YGNodeRef node);
 bool YGNodeLayoutGetDidUseLegacyFlag(YGNodeRef node);
 
 WIN_EXPORT void YGNodeStyleSetDirection(YGNodeRef node, YGDirection direction);
@@ -315,6 +373,7 @@ WIN_EXPORT void YGAssertWithConfig(
 WIN_EXPORT void YGConfigSetPointScaleFactor(
     YGConfigRef config,
     float pixelsInPoint);
+WIN_EXPORT float YGConfigGetPointScaleFactor(YGConfigRef config);
 void YGConfigSetShouldDiffLayoutWithoutLegacyStretchBehaviour(
     YGConfigRef config,
     bool shouldDiffLayout);
@@ -355,6 +414,57 @@ WIN_EXPORT void YGConfigSetCloneNodeFunc(
 // Export only for C#
 WIN_EXPORT YGConfigRef YGConfigGetDefault(void);
 
+// Lays out the independent sibling subtrees of a resolved flex line on a
+// work-stealing pool once their nodes number at least the threshold. Subtrees
+// with a measure or baseline func stay on the calling thread. The pool threads
+// start with the first such batch; builds without THREADS_ENABLED have no pool
+// and lay everything out on the calling thread.
+WIN_EXPORT void YGConfigSetParallelLayout(YGConfigRef config, bool enabled);
+WIN_EXPORT bool YGConfigGetParallelLayout(YGConfigRef config);
+WIN_EXPORT void YGConfigSetParallelLayoutThreshold(
+    YGConfigRef config,
+    uint32_t threshold);
+WIN_EXPORT uint32_t YGConfigGetParallelLayoutThreshold(YGConfigRef config);
+
+// Nodes with this config whose width and height are fixed in points, and
+// whose size and margins do not depend on their owner or an ancestor
+// baseline, become layout boundaries. Changes to their children or measured
+// content then stop there instead of dirtying every ancestor, and
+// YGNodeCalculateLayout on the root lays out just their subtree again with
+// the constraints they got last time. Use YGNodeNeedsLayout on the root
+// rather than YGNodeIsDirty to find out if a layout is due.
+WIN_EXPORT void YGConfigSetLayoutBoundaries(YGConfigRef config, bool enabled);
+WIN_EXPORT bool YGConfigGetLayoutBoundaries(YGConfigRef config);
+
+// Number of measurements each node keeps when a tree whose root uses this
+// config is laid out, clamped to [1, 32] and 8 by default. The flush policy
+// starts over from the first entry once the cache is full, LRU replaces the
+// least recently hit one.
+WIN_EXPORT void YGConfigSetMeasurementCacheSize(
+    YGConfigRef config,
+    uint32_t size);
+WIN_EXPORT uint32_t YGConfigGetMeasurementCacheSize(YGConfigRef config);
+WIN_EXPORT void YGConfigSetMeasurementCachePolicy(
+    YGConfigRef config,
+    YGMeasurementCachePolicy policy);
+WIN_EXPORT YGMeasurementCachePolicy
+YGConfigGetMeasurementCachePolicy(YGConfigRef config);
+
+// Nodes created with a config that has an arena, their clones and their
+// child arrays are carved out of its slabs. Resetting or freeing the arena
+// destroys the nodes still in it without YGNodeFree: nothing is unlinked from
+// nodes of other arenas and no deallocation event is published. None of its
+// nodes may be used afterwards. The arena is not thread safe.
+WIN_EXPORT YGNodeArenaRef YGNodeArenaNew(void);
+WIN_EXPORT void YGNodeArenaFree(YGNodeArenaRef arena);
+WIN_EXPORT void YGNodeArenaReset(YGNodeArenaRef arena);
+WIN_EXPORT void YGConfigSetNodeArena(YGConfigRef config, YGNodeArenaRef arena);
+WIN_EXPORT YGNodeArenaRef YGConfigGetNodeArena(YGConfigRef config);
+
+// Only the config of the root is used when calculating a layout.
+WIN_EXPORT void YGNodeSetConfig(YGNodeRef node, YGConfigRef config);
+WIN_EXPORT YGConfigRef YGNodeGetConfig(YGNodeRef node);
+
 WIN_EXPORT void YGConfigSetContext(YGConfigRef config, void* context);
 WIN_EXPORT void* YGConfigGetContext(YGConfigRef config);
 
@@ -44,6 +44,8 @@ struct LayoutData {
   int maxMeasureCache;
   int cachedLayouts;
   int cachedMeasures;
+  // Measurement cache entries dropped to make room for new ones.
+  int measureCacheEvictions;
   int measureCallbacks;
   std::array<int, static_cast<uint8_t>(LayoutPassReason::COUNT)>
       measureCallbackReasonsCount;
@@ -0,0 +1,114 @@
+// Lays a tree out incrementally through a layout boundary and again from
+// scratch, and checks both give the same pixel aligned layout.
+//
+//   scons tests=yes
+//   bin/layout_boundary_test
+
+#include <cstdio>
+
+#include "src/yoga/Yoga.h"
+
+struct Tree
+{
+    YGNodeRef root;
+    YGNodeRef boundary;
+    YGNodeRef leaf;
+};
+
+// root > wrapper > boundary (fixed size) > leaf, with fractional margins so
+// the absolute origin of the boundary is off the pixel grid.
+static Tree buildTree(YGConfigRef config, float wrapperMargin, float boundaryMargin, float leafWidth)
+{
+    Tree tree;
+    tree.root = YGNodeNewWithConfig(config);
+    YGNodeStyleSetWidth(tree.root, 200);
+    YGNodeStyleSetHeight(tree.root, 200);
+
+    YGNodeRef wrapper = YGNodeNewWithConfig(config);
+    YGNodeStyleSetMargin(wrapper, YGEdgeAll, wrapperMargin);
+    YGNodeInsertChild(tree.root, wrapper, 0);
+
+    tree.boundary = YGNodeNewWithConfig(config);
+    YGNodeStyleSetWidth(tree.boundary, 100);
+    YGNodeStyleSetHeight(tree.boundary, 100);
+    YGNodeStyleSetMargin(tree.boundary, YGEdgeAll, boundaryMargin);
+    YGNodeStyleSetFlexDirection(tree.boundary, YGFlexDirectionRow);
+    YGNodeInsertChild(wrapper, tree.boundary, 0);
+
+    tree.leaf = YGNodeNewWithConfig(config);
+    YGNodeStyleSetWidth(tree.leaf, leafWidth);
+    YGNodeStyleSetHeight(tree.leaf, 10);
+    YGNodeStyleSetMargin(tree.leaf, YGEdgeAll, 0.3f);
+    YGNodeInsertChild(tree.boundary, tree.leaf, 0);
+
+    YGNodeRef sibling = YGNodeNewWithConfig(config);
+    YGNodeStyleSetWidth(sibling, 20.4f);
+    YGNodeStyleSetHeight(sibling, 10);
+    YGNodeInsertChild(tree.boundary, sibling, 1);
+    return tree;
+}
+
+static bool sameLayout(YGNodeRef a, YGNodeRef b)
+{
+    if (YGNodeLayoutGetLeft(a) != YGNodeLayoutGetLeft(b) ||
+        YGNodeLayoutGetTop(a) != YGNodeLayoutGetTop(b) ||
+        YGNodeLayoutGetWidth(a) != YGNodeLayoutGetWidth(b) ||
+        YGNodeLayoutGetHeight(a) != YGNodeLayoutGetHeight(b) ||
+        YGNodeGetChildCount(a) != YGNodeGetChildCount(b))
+    {
+        return false;
+    }
+    for (uint32_t i = 0; i < YGNodeGetChildCount(a); i++)
+    {
+        if (!sameLayout(YGNodeGetChild(a, i), YGNodeGetChild(b, i)))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main()
+{
+    const float margins[] = {0.0f, 0.3f, 0.5f, 0.6f, 0.75f};
+    const float widths[] = {10.0f, 10.25f, 10.5f, 11.7f};
+    YGConfigRef config = YGConfigNew();
+    YGConfigSetLayoutBoundaries(config, true);
+    YGConfigSetPointScaleFactor(config, 1.0f);
+
+    int failures = 0;
+    for (const float wrapperMargin : margins)
+    {
+        for (const float boundaryMargin : margins)
+        {
+            for (const float width : widths)
+            {
+                Tree incremental = buildTree(config, wrapperMargin, boundaryMargin, 10.0f);
+                YGNodeCalculateLayout(incremental.root, YGUndefined, YGUndefined, YGDirectionLTR);
+                YGNodeStyleSetWidth(incremental.leaf, width);
+                YGNodeCalculateLayout(incremental.root, YGUndefined, YGUndefined, YGDirectionLTR);
+
+                Tree scratch = buildTree(config, wrapperMargin, boundaryMargin, width);
+                YGNodeCalculateLayout(scratch.root, YGUndefined, YGUndefined, YGDirectionLTR);
+
+                if (!sameLayout(incremental.root, scratch.root))
+                {
+                    printf("FAIL wrapper margin %g, boundary margin %g, leaf width %g: "
+                        "leaf %g,%g %gx%g incrementally, %g,%g %gx%g from scratch\n",
+                        wrapperMargin, boundaryMargin, width,
+                        YGNodeLayoutGetLeft(incremental.leaf), YGNodeLayoutGetTop(incremental.leaf),
+                        YGNodeLayoutGetWidth(incremental.leaf), YGNodeLayoutGetHeight(incremental.leaf),
+                        YGNodeLayoutGetLeft(scratch.leaf), YGNodeLayoutGetTop(scratch.leaf),
+                        YGNodeLayoutGetWidth(scratch.leaf), YGNodeLayoutGetHeight(scratch.leaf));
+                    failures++;
+                }
+                YGNodeFreeRecursive(incremental.root);
+                YGNodeFreeRecursive(scratch.root);
+            }
+        }
+    }
+    YGConfigFree(config);
+
+    printf("%s: %d failure(s)\n", failures == 0 ? "PASS" : "FAIL", failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,88 @@
+// Lays a measured leaf out at widths that come back, and checks that the LRU
+// measurement cache keeps the width hit most recently where the flush policy
+// drops it, and that evictions are counted.
+//
+//   scons tests=yes
+//   bin/measure_cache_test
+
+#include <cstdio>
+
+#include "src/yoga/Yoga-internal.h"
+#include "src/yoga/Yoga.h"
+#include "src/yoga/event/event.h"
+
+using facebook::yoga::LayoutData;
+
+static int failures = 0;
+
+static void check(bool condition, const char* policy, const char* what)
+{
+    if (!condition)
+    {
+        printf("FAIL %s: %s\n", policy, what);
+        failures++;
+    }
+}
+
+// Wrapping text: the narrower, the taller.
+static YGSize measureText(YGNodeRef, float width, YGMeasureMode, float, YGMeasureMode)
+{
+    return YGSize{width, 1000 / width};
+}
+
+struct Passes
+{
+    int lastCallbacks;
+    int evictions;
+};
+
+// A root whose width comes back to 100 in between, around a measured leaf
+// with a two entry cache. The leaf is stretched, so it is measured at exactly
+// the width of the root.
+static Passes layOut(YGMeasurementCachePolicy policy)
+{
+    const float widths[] = {100, 200, 100, 250, 100};
+    YGConfigRef config = YGConfigNew();
+    YGConfigSetMeasurementCacheSize(config, 2);
+    YGConfigSetMeasurementCachePolicy(config, policy);
+
+    YGNodeRef root = YGNodeNewWithConfig(config);
+    YGNodeRef leaf = YGNodeNewWithConfig(config);
+    YGNodeSetMeasureFunc(leaf, measureText);
+    YGNodeInsertChild(root, leaf, 0);
+
+    Passes passes = {};
+    for (const float width : widths)
+    {
+        LayoutData data = {};
+        facebook::yoga::calculateLayoutWithData(root, width, YGUndefined, YGDirectionLTR, nullptr, &data);
+        passes.lastCallbacks = data.measureCallbacks;
+        passes.evictions += data.measureCacheEvictions;
+        if (YGNodeLayoutGetHeight(leaf) != 1000 / width)
+        {
+            printf("FAIL leaf is %g high at %g\n", YGNodeLayoutGetHeight(leaf), width);
+            failures++;
+        }
+    }
+    YGNodeFreeRecursive(root);
+    YGConfigFree(config);
+    return passes;
+}
+
+int main()
+{
+    // 100 is hit on the third pass, so LRU drops 200 for 250 and the last
+    // pass is served from the cache.
+    const Passes lru = layOut(YGMeasurementCachePolicyLRU);
+    check(lru.lastCallbacks == 0, "LRU", "the last pass hits the cache");
+    check(lru.evictions == 1, "LRU", "250 evicts one entry");
+
+    // The flush policy drops both entries and starts over from the first
+    // one, 250 replaces 100.
+    const Passes flush = layOut(YGMeasurementCachePolicyFlush);
+    check(flush.lastCallbacks > 0, "flush", "the last pass measures again");
+    check(flush.evictions == 2, "flush", "250 evicts both entries");
+
+    printf("%s: %d failure(s)\n", failures == 0 ? "PASS" : "FAIL", failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,105 @@
+// Builds trees from a node arena, and checks that freed nodes are reused
+// from the free lists and that a reset keeps the slabs for the next tree.
+// Run it under -fsanitize=address to also check that a reset frees storage
+// nodes keep outside the arena.
+//
+//   scons tests=yes
+//   bin/node_arena_test
+
+#include <cstdio>
+
+#include "src/yoga/YGNodeArena.h"
+#include "src/yoga/Yoga.h"
+
+static int failures = 0;
+
+static void check(bool condition, const char* what)
+{
+    if (!condition)
+    {
+        printf("FAIL %s\n", what);
+        failures++;
+    }
+}
+
+static float baseline(YGNodeRef, float, float height)
+{
+    return height;
+}
+
+// A root with `count` fixed size leaves.
+static YGNodeRef buildTree(YGConfigRef config, int count)
+{
+    YGNodeRef root = YGNodeNewWithConfig(config);
+    YGNodeStyleSetFlexDirection(root, YGFlexDirectionRow);
+    YGNodeStyleSetFlexWrap(root, YGWrapWrap);
+    YGNodeStyleSetWidth(root, 500);
+    for (int i = 0; i < count; i++)
+    {
+        YGNodeRef leaf = YGNodeNewWithConfig(config);
+        YGNodeStyleSetWidth(leaf, 10.5f);
+        YGNodeStyleSetHeight(leaf, 10);
+        YGNodeInsertChild(root, leaf, i);
+    }
+    return root;
+}
+
+int main()
+{
+    YGNodeArenaRef arena = YGNodeArenaNew();
+    YGConfigRef config = YGConfigNew();
+    YGConfigSetNodeArena(config, arena);
+
+    // A freed node goes to the free list, the next node of the arena takes
+    // its storage instead of cutting into the slab.
+    YGNodeRef root = buildTree(config, 1000);
+    YGNodeCalculateLayout(root, YGUndefined, YGUndefined, YGDirectionLTR);
+    const size_t slabs = arena->slabCount();
+    const size_t live = arena->liveAllocationCount();
+    check(slabs > 1, "a thousand nodes fill more than one slab");
+
+    YGNodeRef leaf = YGNodeGetChild(root, 500);
+    YGNodeRemoveChild(root, leaf);
+    YGNodeFree(leaf);
+    check(arena->liveAllocationCount() == live - 1, "freeing a node releases its allocation");
+
+    YGNodeRef reused = YGNodeNewWithConfig(config);
+    check(reused == leaf, "a new node reuses the storage of the last freed one");
+    check(arena->liveAllocationCount() == live, "a reused node counts as live again");
+    YGNodeInsertChild(root, reused, 500);
+    check(arena->slabCount() == slabs, "reusing freed nodes adds no slab");
+
+    // A reset forgets every node at once and keeps the slabs, so the same
+    // tree built again allocates nothing new.
+    YGNodeArenaReset(arena);
+    check(arena->liveAllocationCount() == 0, "a reset releases every allocation");
+    check(arena->slabCount() == slabs, "a reset keeps the slabs");
+
+    root = buildTree(config, 1000);
+    YGNodeCalculateLayout(root, YGUndefined, YGUndefined, YGDirectionLTR);
+    check(arena->liveAllocationCount() == live, "the rebuilt tree has as many allocations");
+    check(arena->slabCount() == slabs, "the rebuilt tree fits the kept slabs");
+
+    // Baseline functions keep storage outside the arena, a reset must run
+    // the destructors of the nodes still alive.
+    for (uint32_t i = 0; i < YGNodeGetChildCount(root); i += 2)
+    {
+        YGNodeSetBaselineFunc(YGNodeGetChild(root, i), baseline);
+    }
+    YGNodeCalculateLayout(root, YGUndefined, YGUndefined, YGDirectionLTR);
+    YGNodeArenaReset(arena);
+    check(arena->liveAllocationCount() == 0, "a reset with out of line storage releases every allocation");
+
+    root = buildTree(config, 1000);
+    YGNodeCalculateLayout(root, YGUndefined, YGUndefined, YGDirectionLTR);
+    check(arena->slabCount() == slabs, "a reset with out of line storage keeps the slabs");
+    check(YGNodeLayoutGetWidth(YGNodeGetChild(root, 999)) == 11.0f, "the rebuilt tree lays out");
+
+    YGNodeFreeRecursive(root);
+    check(arena->liveAllocationCount() == 0, "freeing the tree releases every allocation");
+    YGConfigFree(config);
+    YGNodeArenaFree(arena);
+
+    printf("%s: %d failure(s)\n", failures == 0 ? "PASS" : "FAIL", failures);
+    return failures == 0 ? 0 : 1;
+}
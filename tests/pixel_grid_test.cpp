@@ -0,0 +1,209 @@
+// Edits a tree and lays it out again, so only the re-laid-out subtrees and
+// those that moved are rounded to the pixel grid, and checks the result
+// against the same tree laid out from scratch, at several point scale
+// factors. The scratch layout is also checked against rounding the unrounded
+// layout node by node with YGRoundValueToPixelGrid.
+//
+//   scons tests=yes
+//   bin/pixel_grid_test
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "src/yoga/Utils.h"
+#include "src/yoga/Yoga.h"
+
+// Leaf widths of each row of the tree.
+typedef std::vector<std::vector<float>> Rows;
+
+static YGSize measureText(YGNodeRef node, float width, YGMeasureMode widthMode, float, YGMeasureMode)
+{
+    const float textWidth = 33.37f;
+    return YGSize{widthMode == YGMeasureModeUndefined || width > textWidth ? textWidth : width, 12.3f};
+}
+
+static YGNodeRef buildLeaf(YGConfigRef config, float width)
+{
+    YGNodeRef leaf = YGNodeNewWithConfig(config);
+    YGNodeStyleSetWidth(leaf, width);
+    YGNodeStyleSetHeight(leaf, 7.3f);
+    YGNodeStyleSetMargin(leaf, YGEdgeLeft, 0.45f);
+    return leaf;
+}
+
+// root > rows > leaves, each row ending in a text leaf. Rows are offset by
+// fractional padding and margins so absolute origins are off the grid, and
+// wrap so that edits move the rows below.
+static YGNodeRef buildTree(YGConfigRef config, const Rows& rows)
+{
+    YGNodeRef root = YGNodeNewWithConfig(config);
+    YGNodeStyleSetWidth(root, 151.3f);
+    YGNodeStyleSetPadding(root, YGEdgeAll, 1.7f);
+    for (size_t i = 0; i < rows.size(); i++)
+    {
+        YGNodeRef row = YGNodeNewWithConfig(config);
+        YGNodeStyleSetFlexDirection(row, YGFlexDirectionRow);
+        YGNodeStyleSetFlexWrap(row, YGWrapWrap);
+        YGNodeStyleSetMargin(row, YGEdgeTop, 0.6f);
+        YGNodeStyleSetPadding(row, YGEdgeLeft, 0.35f * (i + 1));
+        for (size_t j = 0; j < rows[i].size(); j++)
+        {
+            YGNodeInsertChild(row, buildLeaf(config, rows[i][j]), j);
+        }
+        YGNodeRef text = YGNodeNewWithConfig(config);
+        YGNodeSetMeasureFunc(text, measureText);
+        YGNodeSetNodeType(text, YGNodeTypeText);
+        YGNodeStyleSetFlexShrink(text, 1);
+        YGNodeInsertChild(row, text, rows[i].size());
+        YGNodeInsertChild(root, row, i);
+    }
+    return root;
+}
+
+static bool sameLayout(YGNodeRef a, YGNodeRef b)
+{
+    if (YGNodeLayoutGetLeft(a) != YGNodeLayoutGetLeft(b) ||
+        YGNodeLayoutGetTop(a) != YGNodeLayoutGetTop(b) ||
+        YGNodeLayoutGetWidth(a) != YGNodeLayoutGetWidth(b) ||
+        YGNodeLayoutGetHeight(a) != YGNodeLayoutGetHeight(b) ||
+        YGNodeGetChildCount(a) != YGNodeGetChildCount(b))
+    {
+        return false;
+    }
+    for (uint32_t i = 0; i < YGNodeGetChildCount(a); i++)
+    {
+        if (!sameLayout(YGNodeGetChild(a, i), YGNodeGetChild(b, i)))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Left, top, width and height of every node in pre-order, rounded the way
+// Yoga did before rounding was batched.
+static void roundRecursively(YGNodeRef node, double scale, double ownerLeft, double ownerTop, std::vector<float>& rounded)
+{
+    const double left = YGNodeLayoutGetLeft(node);
+    const double top = YGNodeLayoutGetTop(node);
+    const double width = YGNodeLayoutGetWidth(node);
+    const double height = YGNodeLayoutGetHeight(node);
+    const double absoluteLeft = ownerLeft + left;
+    const double absoluteTop = ownerTop + top;
+
+    const bool text = YGNodeGetNodeType(node) == YGNodeTypeText;
+    const double widthFraction = std::fmod(width * scale, 1.0);
+    const double heightFraction = std::fmod(height * scale, 1.0);
+    const bool fractionalWidth = !YGDoubleEqual(widthFraction, 0) && !YGDoubleEqual(widthFraction, 1.0);
+    const bool fractionalHeight = !YGDoubleEqual(heightFraction, 0) && !YGDoubleEqual(heightFraction, 1.0);
+
+    rounded.push_back(YGRoundValueToPixelGrid(left, scale, false, text));
+    rounded.push_back(YGRoundValueToPixelGrid(top, scale, false, text));
+    rounded.push_back(
+        YGRoundValueToPixelGrid(absoluteLeft + width, scale, text && fractionalWidth, text && !fractionalWidth) -
+        YGRoundValueToPixelGrid(absoluteLeft, scale, false, text));
+    rounded.push_back(
+        YGRoundValueToPixelGrid(absoluteTop + height, scale, text && fractionalHeight, text && !fractionalHeight) -
+        YGRoundValueToPixelGrid(absoluteTop, scale, false, text));
+    for (uint32_t i = 0; i < YGNodeGetChildCount(node); i++)
+    {
+        roundRecursively(YGNodeGetChild(node, i), scale, absoluteLeft, absoluteTop, rounded);
+    }
+}
+
+static void collectLayout(YGNodeRef node, std::vector<float>& layout)
+{
+    layout.push_back(YGNodeLayoutGetLeft(node));
+    layout.push_back(YGNodeLayoutGetTop(node));
+    layout.push_back(YGNodeLayoutGetWidth(node));
+    layout.push_back(YGNodeLayoutGetHeight(node));
+    for (uint32_t i = 0; i < YGNodeGetChildCount(node); i++)
+    {
+        collectLayout(YGNodeGetChild(node, i), layout);
+    }
+}
+
+int main()
+{
+    const float scales[] = {1.0f, 1.5f, 2.0f, 2.75f, 3.0f};
+    int failures = 0;
+    for (const float scale : scales)
+    {
+        YGConfigRef config = YGConfigNew();
+        YGConfigSetPointScaleFactor(config, scale);
+        YGConfigRef unroundedConfig = YGConfigNew();
+        YGConfigSetPointScaleFactor(unroundedConfig, 0);
+
+        Rows rows;
+        for (int i = 0; i < 8; i++)
+        {
+            rows.push_back({});
+            for (int j = 0; j < 12; j++)
+            {
+                rows.back().push_back(10.0f + 0.37f * (i * 12 + j));
+            }
+        }
+        YGNodeRef incremental = buildTree(config, rows);
+        YGNodeCalculateLayout(incremental, YGUndefined, YGUndefined, YGDirectionLTR);
+
+        // Each edit dirties one row, the other rows keep their earlier
+        // rounded layout and may move.
+        for (int edit = 0; edit < 24; edit++)
+        {
+            const uint32_t i = (edit * 5) % rows.size();
+            YGNodeRef row = YGNodeGetChild(incremental, i);
+            switch (edit % 3)
+            {
+            case 0:
+            {
+                const uint32_t j = edit % rows[i].size();
+                rows[i][j] += 1.13f;
+                YGNodeStyleSetWidth(YGNodeGetChild(row, j), rows[i][j]);
+                break;
+            }
+            case 1:
+                rows[i].insert(rows[i].begin(), 4.9f + edit);
+                YGNodeInsertChild(row, buildLeaf(config, rows[i].front()), 0);
+                break;
+            default:
+            {
+                YGNodeRef leaf = YGNodeGetChild(row, 0);
+                rows[i].erase(rows[i].begin());
+                YGNodeRemoveChild(row, leaf);
+                YGNodeFree(leaf);
+                break;
+            }
+            }
+            YGNodeCalculateLayout(incremental, YGUndefined, YGUndefined, YGDirectionLTR);
+
+            YGNodeRef scratch = buildTree(config, rows);
+            YGNodeCalculateLayout(scratch, YGUndefined, YGUndefined, YGDirectionLTR);
+            if (!sameLayout(incremental, scratch))
+            {
+                printf("FAIL scale %g, edit %d of row %u: rounded layout differs from scratch\n", scale, edit, i);
+                failures++;
+            }
+
+            YGNodeRef unrounded = buildTree(unroundedConfig, rows);
+            YGNodeCalculateLayout(unrounded, YGUndefined, YGUndefined, YGDirectionLTR);
+            std::vector<float> expected;
+            roundRecursively(unrounded, scale, 0.0, 0.0, expected);
+            std::vector<float> actual;
+            collectLayout(scratch, actual);
+            if (actual != expected)
+            {
+                printf("FAIL scale %g, edit %d: rounded layout differs from rounding node by node\n", scale, edit);
+                failures++;
+            }
+            YGNodeFreeRecursive(scratch);
+            YGNodeFreeRecursive(unrounded);
+        }
+        YGNodeFreeRecursive(incremental);
+        YGConfigFree(config);
+        YGConfigFree(unroundedConfig);
+    }
+
+    printf("%s: %d failure(s)\n", failures == 0 ? "PASS" : "FAIL", failures);
+    return failures == 0 ? 0 : 1;
+}